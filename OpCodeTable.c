@@ -43,175 +43,19 @@
 *     Date     Tracker  Pgmr  Description
 *  ----------  -------  ----  ----------------------------------------------------------------------------------------------------------
 *  01/09/2015  Initial  ADCL  This is the initial version.  I have gone through several iterations to date.
+*  10/16/2026   U-004   ADCL  Moved the type definitions to OpCodeTable.h; added a perfect hash from mnemonic to its OpCodeTable rows.
+*  10/16/2026   U-010   ADCL  Added the operand-signature dispatch index.
+*  10/16/2026   U-011   ADCL  The dispatch index is built per active ISA as an OpCodeView; corrected the CPU of the 186+ rows.
+*  10/16/2026   U-012   ADCL  Corrected the opcodes of MOV r16,imm16 (B8+r) and LEA (8D); PUSH imm has no ModR/M byte.
+*  10/16/2026   U-017   ADCL  An IMM8 that is not sign-extended accepts OC_IMMREL, so a byte may be a forward reference.
 *
 *****************************************************************************************************************************************
 */
 
-#include <stdint.h>
-#include <string.h>
+#include "OpCodeTable.h"
 
-/*
- * -- This enumerated type is used to indicate which CPUs an OpCode can be executed on.
- *    ---------------------------------------------------------------------------------
- */
-typedef enum {
-    _8086       = 0x00000001,
-    _186        = 0x00000003,
-    _286        = 0x00000007,
-    _386        = 0x0000000f,
-    _486        = 0x0000001f,
-    _586        = 0x0000003f,
-    _PENTIUM    = _586,
-    _PENT       = _586,
-    _686        = 0x0000007f,
-    _PPRO       = _686,
-    _P2         = _686,
-    _P3         = 0x000000ff,
-    _KATMAI     = _P3,
-    _P4         = 0x000001ff,
-    _WILLAMETTE = _P4,
-    _PRESCOTT   = 0x000003ff,
-    _X64        = 0x000007ff,
-    _IA64       = 0x00000fff,
-} CPU;
-
-typedef enum {
-    _16BITS     = 0x00001000,
-    _32BITS     = 0x00002000,
-    _64BITS     = 0x00004000,
-} Bits;
-
-typedef enum {
-    _PRIV       = 0x00010000,
-    _NOLONG     = 0x00080000,
-    _3DNOW      = 0x00100000,
-    _CYRIX      = 0x00200000,
-    _FPU        = 0x00400000,
-    _MMX        = 0x00800000,
-    _SSE        = 0x01000000,
-    _SSE2       = 0x02000000,
-    _UNDOC      = 0x80000000,
-} Flags;
-
-
-
-typedef union Mnemonic {
-    char name[16];
-    uint64_t code[2];
-} Mnemonic;
-
-enum {
-    AAA,
-    AAD,
-    AAM,
-    AAS,
-    ADC,
-    ADD,
-    AND,
-    CALL,
-    CBW,
-    CLC,
-    CLD,
-    CLI,
-    CMC,
-    CMP,
-    CMPSB,
-    CMPSW,
-    CWD,
-    DAA,
-    DAS,
-    DEC,
-    DIV,
-    FWAIT,
-    HLT,
-    IDIV,
-    IMUL,
-    IN,
-    INC,
-    INT,
-    INT3,
-    INT03,
-    INTO,
-    IRET,
-    JA,
-    JAE,
-    JB,
-    JBE,
-    JC,
-    JCXZ,
-    JE,
-    JG,
-    JGE,
-    JL,
-    JLE,
-    JNA,
-    JNAE,
-    JNB,
-    JNBE,
-    JNC,
-    JNE,
-    JNG,
-    JNGE,
-    JNL,
-    JNLE,
-    JO,
-    JP,
-    JPE,
-    JPO,
-    JS,
-    JZ,
-    JMP,
-    LAHF,
-    LDS,
-    LES,
-    LEA,
-    LODSB,
-    LODSW,
-    LOOP,
-    LOOPE,
-    LOOPNE,
-    LOOPNZ,
-    LOOPZ,
-    MOV,
-    MOVSB,
-    MOVSW,
-    MUL,
-    NEG,
-    NOP,
-    NOT,
-    OR,
-    OUT,
-    PAUSE,
-    POP,
-    POPF,
-    PUSH,
-    PUSHF,
-    RCL,
-    RCR,
-    RET,
-    RETF,
-    ROL,
-    ROR,
-    SAHF,
-    SAL,
-    SAR,
-    SBB,
-    SCASB,
-    SCASW,
-    SHL,
-    SHR,
-    STC,
-    STD,
-    STI,
-    STOSB,
-    STOSW,
-    SUB,
-    TEST,
-    WAIT,
-    XCHG,
-    XLAT,
-    XOR,
-};
+#include <pthread.h>
+#include <stdlib.h>
 
 const Mnemonic mnemonics[] = {
     {{'A', 'A', 'A','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0'}},
@@ -326,145 +170,6 @@ const Mnemonic mnemonics[] = {
     {{'X', 'O', 'R','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0','\0'}},
 };
 
-typedef enum {
-    PRE_NONE = 0,
-
-    LOCK = 0x8000,
-    REPNE = 0x4000,
-    REPE = 0x2000,
-
-    CS = 0x0800,
-    SS = 0x0400,
-    DS = 0x0200,
-    ES = 0x0100,
-    FS = 0x0080,
-    GS = 0x0040,
-    HINT_N = 0x0020,
-    HINT_Y = 0x0010,
-
-    O32 = 0x0008,
-    O16 = 0x0004,
-
-    A32 = 0x0002,
-    A16 = 0x0001,
-} Prefixes;
-
-typedef enum {
-    REX_NONE = 0,
-
-    REX_B = 0x41,
-    REX_X = 0x42,
-    REX_R = 0x44,
-    REX_W = 0x48,
-
-    REX = 0x40,
-} RexPrefix;
-
-typedef enum {
-    OP_NONE = 0,
-    REL8,
-    REL16,
-    REL32,
-    PTR16_16,
-    PTR16_32,
-    R8,
-    R16,
-    R32,
-    R64,
-    IMM8,
-    IMM16,
-    IMM32,
-    IMM64,
-    RM8,
-    RM16,
-    RM32,
-    RM64,
-    M,
-    M8,
-    M16,
-    M32,
-    M64,
-    M128,
-    M16_16,
-    M16_32,
-    M16_64,
-    M16M32,
-    M16M16,
-    M32M32,
-    M16M64,
-    MOFFS8,
-    MOFFS16,
-    MOFFS32,
-    MOFFS64,
-    SREG,
-    M32FP,
-    M64FP,
-    M80FP,
-    M16INT,
-    M32INT,
-    M64INT,
-    ST0,
-    STi,
-    MM,
-    MM_M32,
-    MM_M64,
-    XMM,
-    XMM_M32,
-    XMM_M64,
-    XMM_M128,
-    XMM0,
-    YMM,
-    M256,
-    YMM_M256,
-    YMM0,
-    SRC1,
-    SRC2,
-    SRC3,
-    SRC,
-    DST,
-    REG_AL,
-    REG_AX,
-    REG_CL,
-    REG_CX,
-    REG_DX,
-    REG_BX,
-    REG_SP,
-    REG_BP,
-    REG_SI,
-    REG_DI,
-    REG_EAX,
-    REG_ECX,
-    REG_EDX,
-    REG_EBX,
-    REG_ESP,
-    REG_EBP,
-    REG_ESI,
-    REG_EDI,
-    REG_RAX,
-    REG_CS,
-    REG_DS,
-    REG_ES,
-    REG_FS,
-    REG_GS,
-    REG_SS,
-    ONE,
-} OperandType;
-
-typedef struct OpCodeEntry {
-    const Mnemonic *mnemonic;
-    Prefixes legacyPrefixes;
-    RexPrefix rexPrefix;
-    uint8_t byteCode[3];
-
-    uint8_t modRM_Op:3;
-    uint8_t modRM_Part:1;
-    uint8_t opcodeBytes:3;
-
-    OperandType type[3];
-    uint8_t size;
-    uint32_t flags;
-} OpCodeEntry;
-
 #define _(x)  (&mnemonics[x])
 #define Y 0b1u
 #define N 0b0u
@@ -568,9 +273,9 @@ const OpCodeEntry OpCodeTable[] = {
 
     {  _(IMUL),            LOCK, REX_NONE, {0xf6, 0x00, 0x00}, 05u, Y, 01u, {     RM8, OP_NONE, OP_NONE}, 2u, _8086|_16BITS},
     {  _(IMUL),            LOCK, REX_NONE, {0xf7, 0x00, 0x00}, 05u, Y, 01u, {    RM16, OP_NONE, OP_NONE}, 2u, _8086|_16BITS},
-    {  _(IMUL),            LOCK, REX_NONE, {0x0f, 0xaf, 0x00}, 00u, N, 02u, {     R16,    RM16, OP_NONE}, 3u, _8086|_16BITS},
-    {  _(IMUL),            LOCK, REX_NONE, {0x6b, 0x00, 0x00}, 00u, N, 01u, {     R16,    RM16,    IMM8}, 3u, _8086|_16BITS},
-    {  _(IMUL),            LOCK, REX_NONE, {0x69, 0x00, 0x00}, 00u, N, 01u, {     R16,    RM16,   IMM16}, 4u, _8086|_16BITS},
+    {  _(IMUL),            LOCK, REX_NONE, {0x0f, 0xaf, 0x00}, 00u, N, 02u, {     R16,    RM16, OP_NONE}, 3u, _386|_16BITS},
+    {  _(IMUL),            LOCK, REX_NONE, {0x6b, 0x00, 0x00}, 00u, N, 01u, {     R16,    RM16,    IMM8}, 3u, _186|_16BITS},
+    {  _(IMUL),            LOCK, REX_NONE, {0x69, 0x00, 0x00}, 00u, N, 01u, {     R16,    RM16,   IMM16}, 4u, _186|_16BITS},
 
     {    _(IN),        PRE_NONE, REX_NONE, {0xe4, 0x00, 0x00}, 00u, N, 01u, {  REG_AL,    IMM8, OP_NONE}, 2u, _8086|_16BITS},
     {    _(IN),        PRE_NONE, REX_NONE, {0xe5, 0x00, 0x00}, 00u, N, 01u, {  REG_AX,    IMM8, OP_NONE}, 2u, _8086|_16BITS},
@@ -638,7 +343,7 @@ const OpCodeEntry OpCodeTable[] = {
     {   _(LDS),        PRE_NONE, REX_NONE, {0xc5, 0x00, 0x00}, 00u, N, 01u, {     R16,  M16_16, OP_NONE}, 6u, _8086|_16BITS|_NOLONG},
     {   _(LES),        PRE_NONE, REX_NONE, {0xc4, 0x00, 0x00}, 00u, N, 01u, {     R16,  M16_16, OP_NONE}, 6u, _8086|_16BITS|_NOLONG},
 
-    {   _(LEA),        PRE_NONE, REX_NONE, {0xbd, 0x00, 0x00}, 00u, N, 01u, {     R16,       M, OP_NONE}, 4u, _8086|_16BITS},
+    {   _(LEA),        PRE_NONE, REX_NONE, {0x8d, 0x00, 0x00}, 00u, N, 01u, {     R16,       M, OP_NONE}, 4u, _8086|_16BITS},
 
     { _(LODSB), REPE|REPNE|LOCK, REX_NONE, {0xac, 0x00, 0x00}, 00u, N, 01u, { OP_NONE, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
 
@@ -665,7 +370,7 @@ const OpCodeEntry OpCodeTable[] = {
     {   _(MOV),           DS|ES, REX_NONE, {0xa2, 0x00, 0x00}, 00u, N, 01u, {  MOFFS8,  REG_AL, OP_NONE}, 2u, _8086|_16BITS},
     {   _(MOV),           DS|ES, REX_NONE, {0xa3, 0x00, 0x00}, 00u, N, 01u, { MOFFS16,  REG_AX, OP_NONE}, 3u, _8086|_16BITS},
     {   _(MOV),        PRE_NONE, REX_NONE, {0xb0, 0x00, 0x00}, 00u, N, 01u, {      R8,    IMM8, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(MOV),        PRE_NONE, REX_NONE, {0xb1, 0x00, 0x00}, 00u, N, 01u, {     R16,   IMM16, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(MOV),        PRE_NONE, REX_NONE, {0xb8, 0x00, 0x00}, 00u, N, 01u, {     R16,   IMM16, OP_NONE}, 3u, _8086|_16BITS},
     {   _(MOV),            LOCK, REX_NONE, {0xc6, 0x00, 0x00}, 00u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 2u, _8086|_16BITS},
     {   _(MOV),            LOCK, REX_NONE, {0xc7, 0x00, 0x00}, 00u, Y, 01u, {    RM16,   IMM16, OP_NONE}, 3u, _8086|_16BITS},
 
@@ -699,7 +404,7 @@ const OpCodeEntry OpCodeTable[] = {
     {   _(OUT),        PRE_NONE, REX_NONE, {0xee, 0x00, 0x00}, 00u, N, 01u, {  REG_DX,  REG_AL, OP_NONE}, 1u, _8086|_16BITS},
     {   _(OUT),        PRE_NONE, REX_NONE, {0xef, 0x00, 0x00}, 00u, N, 01u, {  REG_DX,  REG_AX, OP_NONE}, 1u, _8086|_16BITS},
 
-    { _(PAUSE),        PRE_NONE, REX_NONE, {0xf3, 0x90, 0x00}, 00u, N, 02u, { OP_NONE, OP_NONE, OP_NONE}, 2u, _8086|_16BITS},
+    { _(PAUSE),        PRE_NONE, REX_NONE, {0xf3, 0x90, 0x00}, 00u, N, 02u, { OP_NONE, OP_NONE, OP_NONE}, 2u, _P4|_16BITS},
 
     {   _(POP),            LOCK, REX_NONE, {0x8f, 0x00, 0x00}, 00u, Y, 01u, {    RM16, OP_NONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(POP),        PRE_NONE, REX_NONE, {0x58, 0x00, 0x00}, 00u, N, 01u, {  REG_AX, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
@@ -717,8 +422,8 @@ const OpCodeEntry OpCodeTable[] = {
     {  _(POPF),        PRE_NONE, REX_NONE, {0x9d, 0x00, 0x00}, 00u, N, 01u, { OP_NONE, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
 
     {  _(PUSH),        PRE_NONE, REX_NONE, {0xff, 0x00, 0x00}, 06u, Y, 01u, {    RM16, OP_NONE, OP_NONE}, 2u, _8086|_16BITS},
-    {  _(PUSH),        PRE_NONE, REX_NONE, {0x6a, 0x00, 0x00}, 06u, Y, 01u, {    IMM8, OP_NONE, OP_NONE}, 2u, _8086|_16BITS},
-    {  _(PUSH),        PRE_NONE, REX_NONE, {0x68, 0x00, 0x00}, 06u, Y, 01u, {   IMM16, OP_NONE, OP_NONE}, 3u, _8086|_16BITS},
+    {  _(PUSH),        PRE_NONE, REX_NONE, {0x6a, 0x00, 0x00}, 00u, N, 01u, {    IMM8, OP_NONE, OP_NONE}, 2u, _186|_16BITS},
+    {  _(PUSH),        PRE_NONE, REX_NONE, {0x68, 0x00, 0x00}, 00u, N, 01u, {   IMM16, OP_NONE, OP_NONE}, 3u, _186|_16BITS},
     {  _(PUSH),        PRE_NONE, REX_NONE, {0x50, 0x00, 0x00}, 00u, N, 01u, {  REG_AX, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
     {  _(PUSH),        PRE_NONE, REX_NONE, {0x51, 0x00, 0x00}, 00u, N, 01u, {  REG_CX, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
     {  _(PUSH),        PRE_NONE, REX_NONE, {0x52, 0x00, 0x00}, 00u, N, 01u, {  REG_DX, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
@@ -736,17 +441,17 @@ const OpCodeEntry OpCodeTable[] = {
 
     {   _(RCL),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 02u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(RCL),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 02u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(RCL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 02u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(RCL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 02u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(RCL),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 02u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(RCL),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 02u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(RCL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 02u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(RCL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 02u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(RCR),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 03u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(RCR),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 03u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(RCR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 03u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(RCR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 03u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(RCR),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 03u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(RCR),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 03u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(RCR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 03u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(RCR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 03u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(RET),        PRE_NONE, REX_NONE, {0xc3, 0x00, 0x00}, 00u, N, 01u, { OP_NONE, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
     {   _(RET),        PRE_NONE, REX_NONE, {0xc2, 0x00, 0x00}, 00u, N, 01u, {   IMM16, OP_NONE, OP_NONE}, 3u, _8086|_16BITS},
@@ -756,47 +461,47 @@ const OpCodeEntry OpCodeTable[] = {
 
     {   _(ROL),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 00u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(ROL),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 00u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(ROL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 00u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(ROL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 00u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(ROL),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 00u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(ROL),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 00u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(ROL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 00u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(ROL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 00u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(ROR),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 01u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(ROR),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 01u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(ROR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 01u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(ROR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 01u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(ROR),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 01u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(ROR),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 01u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(ROR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 01u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(ROR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 01u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {  _(SAHF),        PRE_NONE, REX_NONE, {0x9e, 0x00, 0x00}, 00u, N, 01u, { OP_NONE, OP_NONE, OP_NONE}, 1u, _8086|_16BITS},
 
     {   _(SAL),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 04u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SAL),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 04u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SAL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 04u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SAL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 04u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(SAL),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 04u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SAL),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 04u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SAL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 04u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SAL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 04u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(SAR),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 07u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SAR),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 07u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SAR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 07u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SAR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 07u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(SAR),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 07u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SAR),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 07u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SAR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 07u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SAR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 07u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(SHL),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 04u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SHL),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 04u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SHL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 04u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SHL),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 04u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(SHL),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 04u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SHL),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 04u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SHL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 04u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SHL),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 04u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(SHR),        PRE_NONE, REX_NONE, {0xd0, 0x00, 0x00}, 05u, Y, 01u, {     RM8,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SHR),        PRE_NONE, REX_NONE, {0xd2, 0x00, 0x00}, 05u, Y, 01u, {     RM8,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SHR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 05u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SHR),        PRE_NONE, REX_NONE, {0xc0, 0x00, 0x00}, 05u, Y, 01u, {     RM8,    IMM8, OP_NONE}, 3u, _186|_16BITS},
     {   _(SHR),        PRE_NONE, REX_NONE, {0xd1, 0x00, 0x00}, 05u, Y, 01u, {    RM16,     ONE, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SHR),        PRE_NONE, REX_NONE, {0xd3, 0x00, 0x00}, 05u, Y, 01u, {    RM16,  REG_CL, OP_NONE}, 2u, _8086|_16BITS},
-    {   _(SHR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 05u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _8086|_16BITS},
+    {   _(SHR),        PRE_NONE, REX_NONE, {0xc1, 0x00, 0x00}, 05u, Y, 01u, {    RM16,    IMM8, OP_NONE}, 3u, _186|_16BITS},
 
     {   _(SBB),        PRE_NONE, REX_NONE, {0x1c, 0x00, 0x00}, 00u, N, 01u, {  REG_AL,    IMM8, OP_NONE}, 2u, _8086|_16BITS},
     {   _(SBB),        PRE_NONE, REX_NONE, {0x1d, 0x00, 0x00}, 00u, N, 01u, {  REG_AX,   IMM16, OP_NONE}, 3u, _8086|_16BITS},
@@ -876,23 +581,558 @@ const OpCodeEntry OpCodeTable[] = {
 
 #define ENTRY_COUNT    (sizeof(OpCodeTable) / sizeof(OpCodeEntry))
 
-typedef enum {
-    false = 0,
-    true = !false,
-} bool;
+const size_t OpCodeCount = ENTRY_COUNT;
+
+_Static_assert(sizeof(mnemonics) / sizeof(Mnemonic) == MNEMONIC_COUNT, "mnemonics[] does not match the mnemonic enum");
+
+
+/*
+ * -- The mnemonic perfect hash.  This is a "hash and displace" scheme: a key's first hash picks a bucket, and each bucket has its own
+ *    seed for a second hash that picks the slot.  The seeds are searched once by OpCodeInit() so that no 2 mnemonics share a slot.
+ *    A lookup is therefore 2 hash computations and a single 16-byte compare, however large the instruction set gets.  The slot
+ *    count must be a power of 2 and should stay at least twice the number of mnemonics; raise these as the roadmap adds mnemonics.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+#define MN_HASH_SLOTS       256
+#define MN_HASH_BUCKETS     64
+
+_Static_assert(MNEMONIC_COUNT * 2 <= MN_HASH_SLOTS, "MN_HASH_SLOTS is too small for the mnemonic count");
+
+typedef struct MnemonicSlot {
+    Mnemonic key;
+    uint16_t first;
+    uint16_t count;
+} MnemonicSlot;
+
+static uint16_t mnHashSeed[MN_HASH_BUCKETS];
+static MnemonicSlot mnHashSlot[MN_HASH_SLOTS];
+
+static inline uint32_t MnemonicHash(Mnemonic mn, uint32_t seed)
+{
+    uint64_t h = (mn.code[0] ^ (seed * 0x9e3779b97f4a7c15ull)) * 0xff51afd7ed558ccdull;
+
+    h ^= mn.code[1] + (h >> 29);
+    h *= 0xc4ceb9fe1a85ec53ull;
+
+    return (uint32_t)(h >> 32);
+}
+
+
+/*
+ * -- The operand-signature dispatch index.  Every row is expanded once into each combination of operand classes it accepts; the
+ *    (mnemonic, signature) keys are sorted with the best row first and put in an open-addressed hash that maps each key to its run
+ *    of rows in sigRows[].  Matching the operands of an instruction is then one hash probe rather than a walk over all the rows of
+ *    the mnemonic testing each operand.
+ *
+ *    The index belongs to an OpCodeView, which is built from only the rows that are available to one active ISA (the CPU, the bit
+ *    mode, and the feature flags chosen by the directives).  The ISA is checked once per row when the view is built, never while
+ *    matching.  Views are built on first use and kept for the life of the process; a source file only ever uses a handful.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+#define SIG_BITS            (3 * OC_BITS)
+
+typedef struct SigPair {
+    uint32_t key;
+    uint16_t row;
+    uint16_t rank;
+} SigPair;
+
+typedef struct SigSlot {
+    uint32_t key;
+    uint32_t first;
+    uint32_t count;                                 /* 0 for an unused slot */
+} SigSlot;
+
+struct OpCodeView {
+    uint32_t isa;
+    const OpCodeEntry **rows;                       /* the eligible rows, grouped by mnemonic */
+    uint16_t first[MNEMONIC_COUNT];
+    uint16_t count[MNEMONIC_COUNT];
+    const OpCodeEntry **sigRows;
+    SigSlot *sigSlot;
+    uint32_t sigSlotMask;
+    struct OpCodeView *next;
+};
+
+static OpCodeView *views;
+static pthread_mutex_t viewLock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint32_t SigHash(uint32_t key)
+{
+    return (uint32_t)(((uint64_t)key * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+
+/*
+ * -- SignExtendedImm8() is true for the rows whose IMM8 is sign-extended to a word (83 /n, PUSH 6A, IMUL 6B); these only accept a
+ *    value in -128..127.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+static bool SignExtendedImm8(const OpCodeEntry *e)
+{
+    return e->byteCode[0] == 0x83 || e->byteCode[0] == 0x6a || e->byteCode[0] == 0x6b;
+}
+
+
+/*
+ * -- AcceptedClasses() fills cls[] with the operand classes that an OperandType accepts and returns how many there are.  An
+ *    OperandType this assembler cannot yet produce (32-bit registers, FPU and vector operands, ...) accepts nothing.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+static size_t AcceptedClasses(const OpCodeEntry *e, OperandType t, uint8_t *cls)
+{
+    size_t n = 0;
+    int c;
+
+    switch (t) {
+    case OP_NONE:   cls[n ++] = OC_NONE;                                                break;
+    case ONE:       cls[n ++] = OC_ONE;                                                 break;
+
+    case REL8:
+    case REL16:
+    case IMM16:
+        cls[n ++] = OC_IMM16;
+        /* fall through */
+    case IMM8:
+        if (t != IMM8 || !SignExtendedImm8(e)) {
+            cls[n ++] = OC_IMM8;
+            cls[n ++] = OC_IMMREL;
+        }
+        cls[n ++] = OC_IMM8S;
+        cls[n ++] = OC_ONE;
+        break;
+
+    case PTR16_16:  cls[n ++] = OC_FAR;                                                 break;
+
+    case R8:
+    case RM8:
+        for (c = OC_AL; c <= OC_BH; c ++) cls[n ++] = (uint8_t)c;
+        if (t == R8) break;
+        /* fall through */
+    case M8:
+        cls[n ++] = OC_MEM;
+        cls[n ++] = OC_MEM8;
+        cls[n ++] = OC_MOFFS;
+        cls[n ++] = OC_MOFFS8;
+        break;
+
+    case R16:
+    case RM16:
+        for (c = OC_AX; c <= OC_DI; c ++) cls[n ++] = (uint8_t)c;
+        if (t == R16) break;
+        /* fall through */
+    case M16:
+        cls[n ++] = OC_MEM;
+        cls[n ++] = OC_MEM16;
+        cls[n ++] = OC_MOFFS;
+        cls[n ++] = OC_MOFFS16;
+        break;
+
+    case M:
+        cls[n ++] = OC_MEM;
+        cls[n ++] = OC_MEM8;
+        cls[n ++] = OC_MEM16;
+        cls[n ++] = OC_MEM32;
+        cls[n ++] = OC_MOFFS;
+        cls[n ++] = OC_MOFFS8;
+        cls[n ++] = OC_MOFFS16;
+        break;
+
+    case M16_16:
+        cls[n ++] = OC_MEM32;
+        break;
+
+    case MOFFS8:
+        cls[n ++] = OC_MOFFS;
+        cls[n ++] = OC_MOFFS8;
+        break;
+
+    case MOFFS16:
+        cls[n ++] = OC_MOFFS;
+        cls[n ++] = OC_MOFFS16;
+        break;
+
+    case SREG:      for (c = OC_ES; c <= OC_GS; c ++) cls[n ++] = (uint8_t)c;           break;
+
+    case REG_AL:    cls[n ++] = OC_AL;                                                  break;
+    case REG_CL:    cls[n ++] = OC_CL;                                                  break;
+    case REG_AX:    cls[n ++] = OC_AX;                                                  break;
+    case REG_CX:    cls[n ++] = OC_CX;                                                  break;
+    case REG_DX:    cls[n ++] = OC_DX;                                                  break;
+    case REG_BX:    cls[n ++] = OC_BX;                                                  break;
+    case REG_SP:    cls[n ++] = OC_SP;                                                  break;
+    case REG_BP:    cls[n ++] = OC_BP;                                                  break;
+    case REG_SI:    cls[n ++] = OC_SI;                                                  break;
+    case REG_DI:    cls[n ++] = OC_DI;                                                  break;
+    case REG_CS:    cls[n ++] = OC_CS;                                                  break;
+    case REG_DS:    cls[n ++] = OC_DS;                                                  break;
+    case REG_ES:    cls[n ++] = OC_ES;                                                  break;
+    case REG_FS:    cls[n ++] = OC_FS;                                                  break;
+    case REG_GS:    cls[n ++] = OC_GS;                                                  break;
+    case REG_SS:    cls[n ++] = OC_SS;                                                  break;
+
+    default:                                                                            break;
+    }
+
+    return n;
+}
+
+
+/*
+ * -- RowRank() orders the rows that match the same signature: by the encoded length, and then by how general the operands are,
+ *    so that a fixed-register form (ADD AL,imm8) or MOFFS form (MOV AL,[addr]) wins over a ModR/M form of the same length.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+static uint16_t RowRank(const OpCodeEntry *e)
+{
+    uint16_t generality = 0;
+    int i;
+
+    for (i = 0; i < 3; i ++) {
+        switch (e->type[i]) {
+        case OP_NONE:
+        case ONE:
+            break;
+
+        case MOFFS8:
+        case MOFFS16:
+        case REL8:
+        case REL16:
+        case IMM8:
+        case IMM16:
+        case PTR16_16:
+            generality += 1;
+            break;
+
+        case R8:
+        case R16:
+        case SREG:
+            generality += 2;
+            break;
+
+        default:
+            generality += (e->type[i] >= REG_AL && e->type[i] <= REG_SS ? 0 : 3);
+            break;
+        }
+    }
+
+    return (uint16_t)(e->size * 16 + generality);
+}
+
+
+/*
+ * -- DirectPenalty() adjusts the rank when a direct address is encoded through a ModR/M row: the row's size does not count the
+ *    16-bit displacement that a MOFFS row already includes, so MOV [addr],AX should still prefer A3 over 89 /r.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+static uint16_t DirectPenalty(const OpCodeEntry *e, uint8_t c0, uint8_t c1, uint8_t c2)
+{
+    uint8_t cls[3] = {c0, c1, c2};
+    int i;
+
+    for (i = 0; i < 3; i ++) {
+        if (cls[i] >= OC_MOFFS && cls[i] <= OC_MOFFS16 && e->type[i] != MOFFS8 && e->type[i] != MOFFS16) return 2 * 16;
+    }
+
+    return 0;
+}
+
+static int CompareSigPair(const void *a, const void *b)
+{
+    const SigPair *p = (const SigPair *)a;
+    const SigPair *q = (const SigPair *)b;
+
+    if (p->key != q->key) return (p->key < q->key ? -1 : 1);
+    if (p->rank != q->rank) return (p->rank < q->rank ? -1 : 1);
+    return (int)p->row - (int)q->row;
+}
+
+
+/*
+ * -- BuildSigIndex() builds the dispatch index over the rows of a view.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+static bool BuildSigIndex(OpCodeView *v, size_t rowCount)
+{
+    SigPair *pairs = NULL;
+    size_t pairCount = 0, pairMax = 0, keys = 0, i, j;
+    uint32_t slots;
+
+    for (i = 0; i < rowCount; i ++) {
+        const OpCodeEntry *e = v->rows[i];
+        uint8_t cls[3][OC_COUNT];
+        size_t n[3], a, b, c;
+        uint32_t mn = (uint32_t)(e->mnemonic - mnemonics);
+        uint16_t rank = RowRank(e);
+
+        for (j = 0; j < 3; j ++) n[j] = AcceptedClasses(e, e->type[j], cls[j]);
+
+        if (pairCount + n[0] * n[1] * n[2] > pairMax) {
+            SigPair *p;
+
+            pairMax = (pairMax + n[0] * n[1] * n[2]) * 2;
+            if (!(p = (SigPair *)realloc(pairs, pairMax * sizeof(SigPair)))) {
+                free(pairs);
+                return false;
+            }
+
+            pairs = p;
+        }
+
+        for (a = 0; a < n[0]; a ++) {
+            for (b = 0; b < n[1]; b ++) {
+                for (c = 0; c < n[2]; c ++) {
+                    SigPair *p = &pairs[pairCount ++];
+
+                    p->key = (mn << SIG_BITS) | OPERAND_SIG(cls[0][a], cls[1][b], cls[2][c]);
+                    p->row = (uint16_t)(e - OpCodeTable);
+                    p->rank = rank + DirectPenalty(e, cls[0][a], cls[1][b], cls[2][c]);
+                }
+            }
+        }
+    }
+
+    if (pairCount) qsort(pairs, pairCount, sizeof(SigPair), CompareSigPair);
+
+    for (i = 0; i < pairCount; i ++) if (i == 0 || pairs[i].key != pairs[i - 1].key) keys ++;
+    for (slots = 16; slots < keys * 2; slots <<= 1) ;
+
+    v->sigRows = (const OpCodeEntry **)malloc((pairCount ? pairCount : 1) * sizeof(OpCodeEntry *));
+    v->sigSlot = (SigSlot *)calloc(slots, sizeof(SigSlot));
+    v->sigSlotMask = slots - 1;
+
+    if (!v->sigRows || !v->sigSlot) {
+        free(pairs);
+        return false;
+    }
+
+    for (i = 0; i < pairCount; i = j) {
+        uint32_t h = SigHash(pairs[i].key) & v->sigSlotMask;
+
+        for (j = i; j < pairCount && pairs[j].key == pairs[i].key; j ++) v->sigRows[j] = &OpCodeTable[pairs[j].row];
+        while (v->sigSlot[h].count) h = (h + 1) & v->sigSlotMask;
+
+        v->sigSlot[h].key = pairs[i].key;
+        v->sigSlot[h].first = (uint32_t)i;
+        v->sigSlot[h].count = (uint32_t)(j - i);
+    }
+
+    free(pairs);
+    return true;
+}
 
-static inline Mnemonic MakeMnemonic(const char *op)
+
+static void FreeView(OpCodeView *v)
+{
+    if (!v) return;
+
+    free(v->rows);
+    free(v->sigRows);
+    free(v->sigSlot);
+    free(v);
+}
+
+
+/*
+ * -- BuildView() compacts the rows available to an ISA and builds their dispatch index.  The table is grouped by mnemonic, so
+ *    the eligible rows of each mnemonic stay contiguous.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+static OpCodeView *BuildView(uint32_t isa)
 {
-    Mnemonic rv;
+    OpCodeView *v = (OpCodeView *)calloc(1, sizeof(OpCodeView));
+    size_t n = 0, i;
+
+    if (!v) return NULL;
+
+    v->isa = isa;
+    if (!(v->rows = (const OpCodeEntry **)malloc(ENTRY_COUNT * sizeof(OpCodeEntry *)))) {
+        FreeView(v);
+        return NULL;
+    }
+
+    for (i = 0; i < ENTRY_COUNT; i ++) {
+        const OpCodeEntry *e = &OpCodeTable[i];
+        size_t mn = e->mnemonic - mnemonics;
 
-    rv.code[0] = rv.code[1] = 0;
-    strcpy(rv.name, op);
+        if (!OpCodeAvailable(e->flags, isa)) continue;
 
-    return rv;
+        if (v->count[mn] == 0) v->first[mn] = (uint16_t)n;
+        v->count[mn] ++;
+        v->rows[n ++] = e;
+    }
+
+    if (!BuildSigIndex(v, n)) {
+        FreeView(v);
+        return NULL;
+    }
+
+    return v;
 }
 
-static inline bool CompareMnemonic(Mnemonic mn1, Mnemonic mn2)
+
+/*
+ * -- OpCodeInit() builds the perfect hash.  Buckets are placed largest first, which is what makes the seed search converge quickly.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+bool OpCodeInit(void)
 {
-    return (mn1.code[0] == mn2.code[0] && mn1.code[1] == mn2.code[1]);
+    uint16_t first[MNEMONIC_COUNT];
+    uint16_t count[MNEMONIC_COUNT];
+    uint16_t bucketOf[MNEMONIC_COUNT];
+    uint16_t bucketSize[MN_HASH_BUCKETS];
+    uint16_t order[MN_HASH_BUCKETS];
+    bool used[MN_HASH_SLOTS];
+    size_t i, j, k;
+
+    memset(count, 0, sizeof(count));
+    memset(bucketSize, 0, sizeof(bucketSize));
+    memset(used, 0, sizeof(used));
+
+    /*
+     * -- find the contiguous range of rows for each mnemonic; a mnemonic that shows up in 2 places is an error in the table
+     *    ----------------------------------------------------------------------------------------------------------------------
+     */
+    for (i = 0; i < ENTRY_COUNT; i ++) {
+        size_t mn = OpCodeTable[i].mnemonic - mnemonics;
+
+        if (count[mn] == 0) first[mn] = (uint16_t)i;
+        else if (first[mn] + count[mn] != i) return false;
+
+        count[mn] ++;
+    }
+
+    for (i = 0; i < MNEMONIC_COUNT; i ++) {
+        bucketOf[i] = MnemonicHash(mnemonics[i], 0) & (MN_HASH_BUCKETS - 1);
+        bucketSize[bucketOf[i]] ++;
+    }
+
+    for (i = 0; i < MN_HASH_BUCKETS; i ++) order[i] = (uint16_t)i;
+
+    for (i = 1; i < MN_HASH_BUCKETS; i ++) {
+        uint16_t b = order[i];
+        for (j = i; j > 0 && bucketSize[order[j - 1]] < bucketSize[b]; j --) order[j] = order[j - 1];
+        order[j] = b;
+    }
+
+    for (i = 0; i < MN_HASH_BUCKETS && bucketSize[order[i]]; i ++) {
+        uint16_t b = order[i];
+        uint32_t seed;
+
+        for (seed = 1; seed < 0x10000; seed ++) {
+            uint32_t slots[MNEMONIC_COUNT];
+            size_t n = 0;
+
+            for (k = 0; k < MNEMONIC_COUNT; k ++) {
+                if (bucketOf[k] != b) continue;
+
+                slots[n] = MnemonicHash(mnemonics[k], seed) & (MN_HASH_SLOTS - 1);
+                if (used[slots[n]]) break;
+                for (j = 0; j < n && slots[j] != slots[n]; j ++) ;
+                if (j < n) break;
+                n ++;
+            }
+
+            if (n == bucketSize[b]) {
+                for (j = 0; j < n; j ++) used[slots[j]] = true;
+                break;
+            }
+        }
+
+        if (seed == 0x10000) return false;
+        mnHashSeed[b] = (uint16_t)seed;
+    }
+
+    for (i = 0; i < MNEMONIC_COUNT; i ++) {
+        MnemonicSlot *s = &mnHashSlot[MnemonicHash(mnemonics[i], mnHashSeed[bucketOf[i]]) & (MN_HASH_SLOTS - 1)];
+
+        s->key = mnemonics[i];
+        s->first = first[i];
+        s->count = count[i];
+    }
+
+    pthread_mutex_lock(&viewLock);
+
+    while (views) {
+        OpCodeView *v = views;
+        views = v->next;
+        FreeView(v);
+    }
+
+    views = BuildView(ISA_DEFAULT);
+    pthread_mutex_unlock(&viewLock);
+
+    return views != NULL;
 }
 
+
+/*
+ * -- OpCodeLookup() finds the OpCodeTable rows for an upper-cased mnemonic.  An unused slot has an all-zero key, which can never
+ *    compare equal to a real mnemonic.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+const OpCodeEntry *OpCodeLookup(Mnemonic mn, size_t *count)
+{
+    uint32_t b = MnemonicHash(mn, 0) & (MN_HASH_BUCKETS - 1);
+    const MnemonicSlot *s = &mnHashSlot[MnemonicHash(mn, mnHashSeed[b]) & (MN_HASH_SLOTS - 1)];
+
+    if (!CompareMnemonic(s->key, mn) || s->count == 0) return NULL;
+
+    *count = s->count;
+    return &OpCodeTable[s->first];
+}
+
+
+/*
+ * -- OpCodeSelect() returns the view for an ISA, building it the first time it is asked for.  It is safe to call from any thread.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+const OpCodeView *OpCodeSelect(uint32_t isa)
+{
+    OpCodeView *v;
+
+    pthread_mutex_lock(&viewLock);
+
+    for (v = views; v && v->isa != isa; v = v->next) ;
+
+    if (!v && (v = BuildView(isa)) != NULL) {
+        v->next = views;
+        views = v;
+    }
+
+    pthread_mutex_unlock(&viewLock);
+    return v;
+}
+
+
+/*
+ * -- OpCodeRows() returns the rows of a mnemonic that are available in a view.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+const OpCodeEntry *const *OpCodeRows(const OpCodeView *view, const OpCodeEntry *first, size_t *count)
+{
+    size_t mn = first->mnemonic - mnemonics;
+
+    *count = view->count[mn];
+    return (view->count[mn] ? &view->rows[view->first[mn]] : NULL);
+}
+
+
+/*
+ * -- OpCodeMatch() finds the rows of a mnemonic that accept an operand signature, best first.
+ *    -----------------------------------------------------------------------------------------------------------------------------
+ */
+const OpCodeEntry *const *OpCodeMatch(const OpCodeView *view, const OpCodeEntry *first, uint32_t sig, size_t *count)
+{
+    uint32_t key = ((uint32_t)(first->mnemonic - mnemonics) << SIG_BITS) | sig;
+    uint32_t h;
+
+    for (h = SigHash(key) & view->sigSlotMask; view->sigSlot[h].count; h = (h + 1) & view->sigSlotMask) {
+        if (view->sigSlot[h].key == key) {
+            *count = view->sigSlot[h].count;
+            return &view->sigRows[view->sigSlot[h].first];
+        }
+    }
+
+    return NULL;
+}
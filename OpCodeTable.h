@@ -0,0 +1,501 @@
+/*
+*****************************************************************************************************************************************
+* OpCodeTable.h -- This file contains the type definitions for the OpCode validation table and the prototypes of the functions to read
+*                  it.  The table itself lives in OpCodeTable.c.  This header is included by both the C and the C++ sources.
+*
+*     Date     Tracker  Pgmr  Description
+*  ----------  -------  ----  ----------------------------------------------------------------------------------------------------------
+*  10/16/2026   U-004   ADCL  Split out of OpCodeTable.c so the assembler can read the table; added the mnemonic perfect hash.
+*  10/16/2026   U-005   ADCL  Added MakeMnemonicN() and SSE2 versions of the mnemonic case folding and compare.
+*  10/16/2026   U-010   ADCL  Added the operand classes and OpCodeMatch(), the operand-signature dispatch index.
+*  10/16/2026   U-011   ADCL  Added the active ISA mask and OpCodeView, the rows and dispatch index available to one ISA.
+*  10/16/2026   U-017   ADCL  Added OC_IMMREL, for an immediate that is only known once the file has been read.
+*
+*****************************************************************************************************************************************
+*/
+
+#ifndef __OPCODETABLE_H__
+#define __OPCODETABLE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+ * -- This enumerated type is used to indicate which CPUs an OpCode can be executed on.
+ *    ---------------------------------------------------------------------------------
+ */
+typedef enum {
+    _8086       = 0x00000001,
+    _186        = 0x00000003,
+    _286        = 0x00000007,
+    _386        = 0x0000000f,
+    _486        = 0x0000001f,
+    _586        = 0x0000003f,
+    _PENTIUM    = _586,
+    _PENT       = _586,
+    _686        = 0x0000007f,
+    _PPRO       = _686,
+    _P2         = _686,
+    _P3         = 0x000000ff,
+    _KATMAI     = _P3,
+    _P4         = 0x000001ff,
+    _WILLAMETTE = _P4,
+    _PRESCOTT   = 0x000003ff,
+    _X64        = 0x000007ff,
+    _IA64       = 0x00000fff,
+} CPU;
+
+typedef enum {
+    _16BITS     = 0x00001000,
+    _32BITS     = 0x00002000,
+    _64BITS     = 0x00004000,
+} Bits;
+
+typedef enum {
+    _PRIV       = 0x00010000,
+    _NOLONG     = 0x00080000,
+    _3DNOW      = 0x00100000,
+    _CYRIX      = 0x00200000,
+    _FPU        = 0x00400000,
+    _MMX        = 0x00800000,
+    _SSE        = 0x01000000,
+    _SSE2       = 0x02000000,
+    _UNDOC      = 0x80000000,
+} Flags;
+
+
+
+typedef union Mnemonic {
+    char name[16];
+    uint64_t code[2];
+} Mnemonic;
+
+enum {
+    AAA,
+    AAD,
+    AAM,
+    AAS,
+    ADC,
+    ADD,
+    AND,
+    CALL,
+    CBW,
+    CLC,
+    CLD,
+    CLI,
+    CMC,
+    CMP,
+    CMPSB,
+    CMPSW,
+    CWD,
+    DAA,
+    DAS,
+    DEC,
+    DIV,
+    FWAIT,
+    HLT,
+    IDIV,
+    IMUL,
+    IN,
+    INC,
+    INT,
+    INT3,
+    INT03,
+    INTO,
+    IRET,
+    JA,
+    JAE,
+    JB,
+    JBE,
+    JC,
+    JCXZ,
+    JE,
+    JG,
+    JGE,
+    JL,
+    JLE,
+    JNA,
+    JNAE,
+    JNB,
+    JNBE,
+    JNC,
+    JNE,
+    JNG,
+    JNGE,
+    JNL,
+    JNLE,
+    JO,
+    JP,
+    JPE,
+    JPO,
+    JS,
+    JZ,
+    JMP,
+    LAHF,
+    LDS,
+    LES,
+    LEA,
+    LODSB,
+    LODSW,
+    LOOP,
+    LOOPE,
+    LOOPNE,
+    LOOPNZ,
+    LOOPZ,
+    MOV,
+    MOVSB,
+    MOVSW,
+    MUL,
+    NEG,
+    NOP,
+    NOT,
+    OR,
+    OUT,
+    PAUSE,
+    POP,
+    POPF,
+    PUSH,
+    PUSHF,
+    RCL,
+    RCR,
+    RET,
+    RETF,
+    ROL,
+    ROR,
+    SAHF,
+    SAL,
+    SAR,
+    SBB,
+    SCASB,
+    SCASW,
+    SHL,
+    SHR,
+    STC,
+    STD,
+    STI,
+    STOSB,
+    STOSW,
+    SUB,
+    TEST,
+    WAIT,
+    XCHG,
+    XLAT,
+    XOR,
+
+    MNEMONIC_COUNT
+};
+
+
+typedef enum {
+    PRE_NONE = 0,
+
+    LOCK = 0x8000,
+    REPNE = 0x4000,
+    REPE = 0x2000,
+
+    CS = 0x0800,
+    SS = 0x0400,
+    DS = 0x0200,
+    ES = 0x0100,
+    FS = 0x0080,
+    GS = 0x0040,
+    HINT_N = 0x0020,
+    HINT_Y = 0x0010,
+
+    O32 = 0x0008,
+    O16 = 0x0004,
+
+    A32 = 0x0002,
+    A16 = 0x0001,
+} Prefixes;
+
+typedef enum {
+    REX_NONE = 0,
+
+    REX_B = 0x41,
+    REX_X = 0x42,
+    REX_R = 0x44,
+    REX_W = 0x48,
+
+    REX = 0x40,
+} RexPrefix;
+
+typedef enum {
+    OP_NONE = 0,
+    REL8,
+    REL16,
+    REL32,
+    PTR16_16,
+    PTR16_32,
+    R8,
+    R16,
+    R32,
+    R64,
+    IMM8,
+    IMM16,
+    IMM32,
+    IMM64,
+    RM8,
+    RM16,
+    RM32,
+    RM64,
+    M,
+    M8,
+    M16,
+    M32,
+    M64,
+    M128,
+    M16_16,
+    M16_32,
+    M16_64,
+    M16M32,
+    M16M16,
+    M32M32,
+    M16M64,
+    MOFFS8,
+    MOFFS16,
+    MOFFS32,
+    MOFFS64,
+    SREG,
+    M32FP,
+    M64FP,
+    M80FP,
+    M16INT,
+    M32INT,
+    M64INT,
+    ST0,
+    STi,
+    MM,
+    MM_M32,
+    MM_M64,
+    XMM,
+    XMM_M32,
+    XMM_M64,
+    XMM_M128,
+    XMM0,
+    YMM,
+    M256,
+    YMM_M256,
+    YMM0,
+    SRC1,
+    SRC2,
+    SRC3,
+    SRC,
+    DST,
+    REG_AL,
+    REG_AX,
+    REG_CL,
+    REG_CX,
+    REG_DX,
+    REG_BX,
+    REG_SP,
+    REG_BP,
+    REG_SI,
+    REG_DI,
+    REG_EAX,
+    REG_ECX,
+    REG_EDX,
+    REG_EBX,
+    REG_ESP,
+    REG_EBP,
+    REG_ESI,
+    REG_EDI,
+    REG_RAX,
+    REG_CS,
+    REG_DS,
+    REG_ES,
+    REG_FS,
+    REG_GS,
+    REG_SS,
+    ONE,
+} OperandType;
+
+typedef struct OpCodeEntry {
+    const Mnemonic *mnemonic;
+    Prefixes legacyPrefixes;
+    RexPrefix rexPrefix;
+    uint8_t byteCode[3];
+
+    uint8_t modRM_Op:3;
+    uint8_t modRM_Part:1;
+    uint8_t opcodeBytes:3;
+
+    OperandType type[3];
+    uint8_t size;
+    uint32_t flags;
+} OpCodeEntry;
+
+extern const Mnemonic mnemonics[];
+extern const OpCodeEntry OpCodeTable[];
+extern const size_t OpCodeCount;
+
+/*
+ * -- Building and comparing mnemonics.  MakeMnemonicN() copies a token of len characters into a zero-padded 16-byte Mnemonic and
+ *    upper-cases it; a token of 16 or more characters cannot be a mnemonic and yields the all-zero Mnemonic, which matches nothing.
+ *    With SSE2 both of these are a handful of vector instructions: the token is loaded into one register, bytes past len are masked
+ *    off, 'a'..'z' are found with 2 compares and have 0x20 subtracted, and the comparison is a single pcmpeqb/pmovmskb.  The load
+ *    reads up to 16 bytes from op; when that could cross into the next (possibly unmapped) page the token is copied first.  Without
+ *    SSE2 the scalar versions are used.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+static inline Mnemonic MakeMnemonicN(const char *op, size_t len)
+{
+    Mnemonic rv;
+
+    if (len >= sizeof(rv.name)) {
+        rv.code[0] = rv.code[1] = 0;
+        return rv;
+    }
+
+#ifdef __SSE2__
+    {
+        const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m128i v, lower;
+
+        if (((uintptr_t)op & 4095) <= 4096 - sizeof(rv.name)) {
+            v = _mm_loadu_si128((const __m128i *)op);
+        } else {
+            char tmp[16] = {0};
+            memcpy(tmp, op, len);
+            v = _mm_loadu_si128((const __m128i *)tmp);
+        }
+
+        v = _mm_and_si128(v, _mm_cmpgt_epi8(_mm_set1_epi8((char)len), index));
+        lower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+        v = _mm_sub_epi8(v, _mm_and_si128(lower, _mm_set1_epi8(0x20)));
+        _mm_storeu_si128((__m128i *)rv.name, v);
+    }
+#else
+    {
+        size_t i;
+
+        rv.code[0] = rv.code[1] = 0;
+
+        for (i = 0; i < len; i ++) {
+            char c = op[i];
+            rv.name[i] = (c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+        }
+    }
+#endif
+
+    return rv;
+}
+
+static inline Mnemonic MakeMnemonic(const char *op)
+{
+    return MakeMnemonicN(op, strlen(op));
+}
+
+static inline bool CompareMnemonic(Mnemonic mn1, Mnemonic mn2)
+{
+#ifdef __SSE2__
+    __m128i a = _mm_loadu_si128((const __m128i *)mn1.name);
+    __m128i b = _mm_loadu_si128((const __m128i *)mn2.name);
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xffff;
+#else
+    return (mn1.code[0] == mn2.code[0] && mn1.code[1] == mn2.code[1]);
+#endif
+}
+
+/*
+ * -- The mnemonic perfect hash.  OpCodeInit() must be called once before any lookups (and before any threads are started).  It
+ *    returns false if the table is not grouped by mnemonic.  OpCodeLookup() returns the first OpCodeEntry row for an upper-cased
+ *    mnemonic and sets *count to the number of contiguous rows; it returns NULL for an unknown mnemonic.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+bool OpCodeInit(void);
+const OpCodeEntry *OpCodeLookup(Mnemonic mn, size_t *count);
+
+
+/*
+ * -- The operand classes.  Where an OperandType describes what an OpCode accepts, an OperandClass describes what the programmer
+ *    actually wrote.  Registers are a class each (in the same order as the register encodings, so OC_AL + code is the 8-bit register
+ *    and OC_AX + code the 16-bit one), so that the accumulator and the other fixed-register forms fall out of the same lookup as
+ *    everything else.  A direct address (`[1234h]`, no base or index register) is an OC_MOFFS class since it can use the short
+ *    MOFFS forms as well as any ModR/M form.  Immediates are classed by the smallest range the value fits: OC_IMM8S is -128..127
+ *    (and so also fits the sign-extended IMM8 forms) while OC_IMM8 is 128..255.  An immediate whose value is not known until the end
+ *    of the file (a label, or a forward EQU) is OC_IMMREL: it fits both the IMM8 and the IMM16 forms, but never a sign-extended
+ *    IMM8, and the field the row gives it is checked once the value is known.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+typedef enum {
+    OC_NONE = 0,
+    OC_AL, OC_CL, OC_DL, OC_BL, OC_AH, OC_CH, OC_DH, OC_BH,
+    OC_AX, OC_CX, OC_DX, OC_BX, OC_SP, OC_BP, OC_SI, OC_DI,
+    OC_ES, OC_CS, OC_SS, OC_DS, OC_FS, OC_GS,
+    OC_MEM,                                         /* memory, size not given */
+    OC_MEM8,
+    OC_MEM16,
+    OC_MEM32,                                       /* DWORD or FAR memory: a seg:off pointer */
+    OC_MOFFS,                                       /* direct address, size not given */
+    OC_MOFFS8,
+    OC_MOFFS16,
+    OC_ONE,                                         /* the immediate value 1 */
+    OC_IMM8S,                                       /* immediate -128..127 */
+    OC_IMM8,                                        /* immediate 128..255 */
+    OC_IMM16,                                       /* any other immediate */
+    OC_IMMREL,                                      /* an immediate not yet known */
+    OC_FAR,                                         /* an immediate seg:off */
+
+    OC_COUNT
+} OperandClass;
+
+#define OC_BITS             6
+#define OPERAND_SIG(a,b,c)  ((uint32_t)(a) | ((uint32_t)(b) << OC_BITS) | ((uint32_t)(c) << (2 * OC_BITS)))
+
+/*
+ * -- The active ISA.  This is a mask in the same form as OpCodeEntry.flags: the CPU bits of the selected processor, exactly one of
+ *    the Bits, and the feature Flags that are enabled.  A row is available when its CPU and features are all in the mask and its
+ *    bit mode is the active one -- except that _NOLONG disqualifies a row in 64-bit mode rather than qualifying it.  ISA_DEFAULT
+ *    is what an assembly starts with: any processor and feature, in 16-bit mode.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+#define ISA_CPU_MASK        0x00000fffu
+#define ISA_BITS_MASK       ((uint32_t)(_16BITS | _32BITS | _64BITS))
+#define ISA_FEATURE_MASK    (0xffff0000u & ~(uint32_t)_NOLONG)
+#define ISA_DEFAULT         ((uint32_t)_IA64 | _16BITS | (uint32_t)(_PRIV | _3DNOW | _CYRIX | _FPU | _MMX | _SSE | _SSE2 | _UNDOC))
+
+static inline bool OpCodeAvailable(uint32_t flags, uint32_t isa)
+{
+    if ((flags & ISA_CPU_MASK) & ~isa) return false;
+    if (!(flags & isa & ISA_BITS_MASK)) return false;
+    if ((flags & ISA_FEATURE_MASK) & ~isa) return false;
+    return !((flags & _NOLONG) && (isa & _64BITS));
+}
+
+/*
+ * -- An OpCodeView is the part of the table available to one active ISA, with its own operand-signature dispatch index.
+ *    OpCodeSelect() returns the view for an ISA (building it on first use; it is safe to call from any thread) and NULL only if out
+ *    of memory; a view lives until the next OpCodeInit().  OpCodeInit() builds the view for ISA_DEFAULT up front.
+ *
+ *    OpCodeRows() returns the rows of the mnemonic whose first row is first (as returned by OpCodeLookup()) that are available in
+ *    the view, or NULL if there are none.
+ *
+ *    OpCodeMatch() returns the rows of that mnemonic in the view that can encode the packed classes of the operands written, best
+ *    first, with *count set to the number of rows.  Best is the shortest encoding and, between equal lengths, the most specific
+ *    form (a fixed register or MOFFS operand over a ModR/M one).  It returns NULL when no row matches.
+ *    ---------------------------------------------------------------------------------------------------------------------------
+ */
+typedef struct OpCodeView OpCodeView;
+
+const OpCodeView *OpCodeSelect(uint32_t isa);
+const OpCodeEntry *const *OpCodeRows(const OpCodeView *view, const OpCodeEntry *first, size_t *count);
+const OpCodeEntry *const *OpCodeMatch(const OpCodeView *view, const OpCodeEntry *first, uint32_t sig, size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
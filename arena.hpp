@@ -0,0 +1,102 @@
+//===============================================================================================
+// arena.hpp -- This file contains the class definition for a bump-pointer memory arena.
+//
+// Much of what the assembler allocates (symbols, interned names, expression nodes) lives until
+// the end of the assembly.  Rather than calling new for each of these and never freeing them,
+// they are carved out of large blocks owned by an Arena, and all the blocks are released at
+// once when the Arena is destroyed.  Nothing allocated from an Arena has its destructor run, so
+// only trivially destructible types may be created with Arena::New().
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+//
+//===============================================================================================
+
+#ifndef __ARENA_HPP__
+#define __ARENA_HPP__
+
+#ifndef __cplusplus
+#error The file 'arena.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//-----------------------------------------------------------------------------------------------
+// The Arena class.  Alloc() is a pointer bump in the common case; a new block is only obtained
+// when the current one is exhausted.  A request larger than the block size gets a block of its
+// own.
+//-----------------------------------------------------------------------------------------------
+class Arena {
+public:
+    Arena(size_t bs = 64 * 1024) : blocks(NULL), cur(NULL), end(NULL), blockSize(bs), used(0) {};
+    virtual ~Arena() { Release(); };
+
+private:
+    Arena(const Arena &);
+    Arena &operator=(const Arena &);
+
+public:
+    void *Alloc(size_t size, size_t align = alignof(std::max_align_t)) {
+        char *p = (char *)(((uintptr_t)cur + align - 1) & ~(uintptr_t)(align - 1));
+        if (!cur || p + size > end) p = Grow(size, align);
+        cur = p + size;
+        used += size;
+        return p;
+    };
+
+    template <typename T, typename... Args>
+    T *New(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                "Arena objects never have their destructors called");
+        return new (Alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    };
+
+    size_t BytesUsed(void) const { return used; };
+
+    void Release(void) {
+        while (blocks) {
+            Block *b = blocks;
+            blocks = b->next;
+            free(b);
+        }
+
+        cur = end = NULL;
+        used = 0;
+    };
+
+private:
+    struct Block {
+        Block *next;
+    };
+
+    char *Grow(size_t size, size_t align) {
+        size_t need = sizeof(Block) + size + align;
+        size_t sz = (need > blockSize ? need : blockSize);
+        Block *b = static_cast<Block *>(malloc(sz));
+
+        if (!b) throw std::bad_alloc();
+
+        b->next = blocks;
+        blocks = b;
+        end = (char *)b + sz;
+
+        return (char *)(((uintptr_t)(b + 1) + align - 1) & ~(uintptr_t)(align - 1));
+    };
+
+private:
+    Block *blocks;
+    char *cur;
+    char *end;
+    size_t blockSize;
+    size_t used;
+};
+
+//===============================================================================================
+
+#endif
@@ -4,106 +4,607 @@
 //    Date     PGMR  Tracker  Description
 // ----------  ----  -------  -------------------------------------------------------------------
 // 2015-01-30  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-004   Build the mnemonic perfect hash at startup
+// 2026-10-16  ADCL   U-006   InitSymbols() is enabled against the new SymbolTable
+// 2026-10-16  ADCL   U-008   Added the INCLUDE and ONCE directives
+// 2026-10-16  ADCL   U-009   main() assembles every file on the command line on a thread pool
+// 2026-10-16  ADCL   U-011   Added the BITS directive
+// 2026-10-16  ADCL   U-014   Write an ELF32 or ELF64 object file for each input (-f)
+// 2026-10-16  ADCL   U-015   Added the flat binary output format (-f bin)
+// 2026-10-16  ADCL   U-016   Undefined symbols are externals in an object file
+// 2026-10-16  ADCL   U-019   Added the assembly cache (-c)
+// 2026-10-16  ADCL   U-020   InitSymbols() moved to symtab.cc
+// 2026-10-16  ADCL   U-021   Added the server (-S) and its client (-s); main() is now Run()
+// 2026-10-16  ADCL   U-022   Added the disassembler (-d) and its round trip check (-r)
+// 2026-10-16  ADCL   U-023   Threads not needed for other files lex a large file ahead
+// 2026-10-16  ADCL   U-024   Added the pipelined assembly (-p)
+// 2026-10-16  ADCL   U-025   Added --stats and --trace
+// 2026-10-16  ADCL   U-019   The cache key has each include path as the directory it names
+// 2026-10-16  ADCL   U-021   The server reads its files into memory rather than mapping them
+// 2026-10-16  ADCL   U-009   -j takes only a positive number of threads
 //
 //===============================================================================================
 
+#include "OpCodeTable.h"
+#include "bin.hpp"
+#include "cache.hpp"
+#include "disasm.hpp"
+#include "elf.hpp"
 #include "in-file.hpp"
 #include "parser.hpp"
+#include "ring.hpp"
+#include "server.hpp"
+#include "stats.hpp"
 #include "symtab.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
-void InitSymbols(void);
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+//-----------------------------------------------------------------------------------------------
+// This is the version of the assembler, which is part of every assembly cache key.
+//-----------------------------------------------------------------------------------------------
+static const char VERSION[] = "0.0";
+
+//-----------------------------------------------------------------------------------------------
+// A Job is one translation unit to assemble.  The diagnostics are collected in the Job so that
+// they can be printed in the order the files were named, no matter which finishes first; so are
+// its Stats, if they were asked for.
+//-----------------------------------------------------------------------------------------------
+struct Job {
+    std::string input;
+    std::string output;
+    std::ostringstream diag;
+    int errors;
+    std::unique_ptr<Stats> stats;
+};
+
+//-----------------------------------------------------------------------------------------------
+// These are the output formats.
+//-----------------------------------------------------------------------------------------------
+typedef enum {FMT_ELF32, FMT_ELF64, FMT_BIN} Format;
+
+//-----------------------------------------------------------------------------------------------
+// These are the options that apply to every Job.
+//-----------------------------------------------------------------------------------------------
+struct Options {
+    std::string cwd;                        // where relative names are from; "" for the current one
+    std::string outDir;
+    std::string cacheDir;
+    std::vector<std::string> includePaths;
+    unsigned threads;
+    unsigned lexThreads;                    // the threads each Job may lex a large file ahead on
+    bool pipeline;                          // each stage of an assembly has a thread of its own
+    bool stats;                             // print the Stats of each Job
+    std::string trace;                      // write every Job's Stats here as a trace, if not ""
+    Format format;
+};
+
+//-----------------------------------------------------------------------------------------------
+// In a pipelined assembly, a Unit is a Job that has been parsed and is waiting for its output to
+// be written.  This is how many may wait for each writer, which bounds the parsed Jobs held.
+//-----------------------------------------------------------------------------------------------
+struct Unit {
+    Job *job;
+    std::unique_ptr<Parser> parser;
+    AssemblyCache::Key key;
+};
+
+static const size_t UNITS_WAITING = 2;
+
+//-----------------------------------------------------------------------------------------------
+// Usage() prints the command line help.
+//-----------------------------------------------------------------------------------------------
+static void Usage(std::ostream &err)
+{
+    err << "usage: as-cent [-f elf32|elf64|bin] [-o outdir] [-I incdir]... [-j threads]\n"
+            "               [-c cachedir] [-p] [--stats] [--trace=file.json] file...\n"
+            "       as-cent -S socket\n"
+            "       as-cent -s socket [option]... file...\n"
+            "       as-cent -d [-b base] file...\n"
+            "       as-cent -r" << std::endl;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Where() is where a name given on the command line really is: relative to the client's working
+// directory when serving one, or else to ours.
+//-----------------------------------------------------------------------------------------------
+static std::string Where(const std::string &name, const Options &opts)
+{
+    if (opts.cwd == "" || name == "" || name[0] == '/') return name;
+    return opts.cwd + "/" + name;
+}
+
+//-----------------------------------------------------------------------------------------------
+// OutputName() works out the output file name for an input: the base name with its extension
+// replaced by .o (or .bin), placed in the output directory (or beside the input if there is
+// none).
+//-----------------------------------------------------------------------------------------------
+static std::string OutputName(const std::string &input, const Options &opts)
+{
+    std::string::size_type slash = input.rfind('/');
+    std::string dir = (slash == std::string::npos ? "" : input.substr(0, slash + 1));
+    std::string base = (slash == std::string::npos ? input : input.substr(slash + 1));
+    std::string::size_type dot = base.rfind('.');
+
+    if (dot != std::string::npos && dot != 0) base.erase(dot);
+    if (opts.outDir != "") dir = opts.outDir + "/";
+
+    return dir + base + (opts.format == FMT_BIN ? ".bin" : ".o");
+}
+
+//-----------------------------------------------------------------------------------------------
+// CacheConfig() is everything about this run, other than the input files, that can change an
+// output: the assembler (its version, and the size and time of its executable, so a rebuild
+// counts), the output format, the initial ISA and the include paths (as canonical directories).
+//-----------------------------------------------------------------------------------------------
+static std::string CacheConfig(const Options &opts)
+{
+    std::ostringstream cfg;
+    struct stat st;
+
+    cfg << VERSION << '\n' << opts.format << '\n' << ISA_DEFAULT << '\n';
+    if (stat("/proc/self/exe", &st) == 0) {
+        cfg << st.st_size << ' ' << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec << '\n';
+    }
+
+    // -- an include path is relative to the directory it was given in, so the key has where it is
+    for (size_t i = 0; i < opts.includePaths.size(); i ++) {
+        std::string dir = Where(opts.includePaths[i], opts);
+        char canon[PATH_MAX];
+
+        cfg << (realpath(dir.c_str(), canon) ? canon : dir.c_str()) << '\n';
+    }
+
+    return cfg.str();
+}
 
 //-----------------------------------------------------------------------------------------------
-// main() is the main entry point.  It will evolve over time as more compnents of the assembler
-// are developed.
+// Translate() parses a single Job, and returns the Parser with its code, or nothing if there is
+// nothing to write.  An object file is placed by the linker, so an ORG only means something for a
+// flat binary.  With a cache, an output found there is used as it is, and key is set for Write()
+// to add a new one to it.
 //-----------------------------------------------------------------------------------------------
-int main(void)
+static std::unique_ptr<Parser> Translate(Job &job, const Options &opts, AssemblyCache *cache,
+        AssemblyCache::Key &key)
 {
-    std::string file = "test.asm";
-    std::string line;
-    int num = 0;
+    try {
+        if (cache && job.input != "") {
+            StageTimer timer(job.stats.get(), "cache");
+            if (cache->Fetch(Where(job.input, opts), Where(job.output, opts), key)) return NULL;
+        }
+
+        std::unique_ptr<Parser> parser(new Parser(job.input, job.diag, opts.cwd));
+
+        for (size_t i = 0; i < opts.includePaths.size(); i ++) {
+            parser->AddIncludePath(opts.includePaths[i]);
+        }
+
+        InitSymbols(parser->Symbols());
+        parser->SetLexThreads(opts.lexThreads);
+        parser->SetPipeline(opts.pipeline);
+        parser->SetStats(job.stats.get());
+        parser->AllowExternals(opts.format != FMT_BIN);
+        parser->Parse();
+        job.errors = parser->Errors();
+
+        if (!job.errors && opts.format != FMT_BIN && parser->Origin()) {
+            job.diag << job.input << ": error: ORG is only valid with -f bin\n";
+            job.errors ++;
+        }
+
+        if (job.errors) return NULL;
 
-    InitSymbols();
-#if 0
-    InputFile::Factory(file);
-    Parser parser;
+        return parser;
+    } catch (std::exception &e) {
+        job.diag << job.input << ": error: " << e.what() << '\n';
+        job.errors ++;
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Write() writes the output of a Job that Translate() parsed without errors, and adds it to the
+// cache.
+//-----------------------------------------------------------------------------------------------
+static void Write(Job &job, Parser &parser, const Options &opts, AssemblyCache *cache,
+        const AssemblyCache::Key &key)
+{
+    StageTimer timer(job.stats.get(), "write");
 
     try {
-        while (1) {
-            line = InputFile::NextLine();
-            std::cout << std::setw(5) << (++ num) << ": " << line << std::endl;
+        if (opts.format == FMT_BIN) BinWriter::Write(Where(job.output, opts), parser.Code());
+        else {
+            ElfWriter::ElfClass cls = ElfWriter::ELF32;
 
-//            parser.ParseLine(line);
-            std::cout << "\t Clean Line: <" << parser.Line() << ">\n";
-            std::cout << std::endl;
+            if (opts.format == FMT_ELF64) cls = ElfWriter::ELF64;
+            ElfWriter::Write(Where(job.output, opts), cls, job.input, parser.Code(),
+                    parser.Labels(), parser.Relocs(), parser.Symbols());
         }
-    } catch(...) {
+
+        if (cache && job.input != "") cache->Store(key, parser.Includes(), Where(job.output, opts));
+    } catch (std::exception &e) {
+        job.diag << job.input << ": error: " << e.what() << '\n';
+        job.errors ++;
     }
-#endif
-    return 0;
 }
 
 //-----------------------------------------------------------------------------------------------
-// InitSymbols() is used to initialize the symbol table to the initial state -- with only the
-// supported registers, opcodes, and directives.
+// Assemble() runs a single Job.  Everything it creates is its own, so several can run at once.
+// The output file is only written if there were no errors.
 //-----------------------------------------------------------------------------------------------
-void InitSymbols(void)
+static void Assemble(Job &job, const Options &opts, AssemblyCache *cache)
 {
-#if 0
-    // -- Start by setting up all the possible directives
-    //    -----------------------------------------------
-    symTab.Insert(Symbol::Factory("CPU", Symbol::SYM_DIRECTIVE));
-    symTab.Insert(Symbol::Factory("8086", Symbol::SYM_DIRECTIVE));
-    symTab.Insert(Symbol::Factory("MODEL", Symbol::SYM_DIRECTIVE));
-    symTab.Insert(Symbol::Factory("ORG", Symbol::SYM_DIRECTIVE));
-    symTab.Insert(Symbol::Factory("EVEV", Symbol::SYM_DIRECTIVE));
-    symTab.Insert(Symbol::Factory("EQU", Symbol::SYM_DIRECTIVE));
-
-    // -- Now, let's establish the register list
-    //    --------------------------------------
-    symTab.Insert(Symbol::Factory("AL", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("AH", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("AX", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("BL", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("BH", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("BX", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("CL", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("CH", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("CX", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("DL", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("DH", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("DX", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("SI", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("DI", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("SP", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("BP", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("CS", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("DS", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("ES", Symbol::SYM_REG));
-    symTab.Insert(Symbol::Factory("SS", Symbol::SYM_REG));
-
-    // -- Next, we setup the qualiiers
-    //    ----------------------------
-    symTab.Insert(Symbol::Factory("BYTE", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("BYTE PTR", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("WORD", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("WORD PTR", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("DWORD", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("DWORD PTR", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("CS:", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("DS:", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("ES:", Symbol::SYM_QUALIFIER));
-    symTab.Insert(Symbol::Factory("SS:", Symbol::SYM_QUALIFIER));
-
-    // -- Finally, the opcodes
-    //    --------------------
-
-
-    symTab.Print();
-#endif
+    AssemblyCache::Key key;
+    std::unique_ptr<Parser> parser = Translate(job, opts, cache, key);
+
+    if (parser) Write(job, *parser, opts, cache, key);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Pipeline() runs Jobs as a pipeline: each file is read and lexed on threads of its own (see
+// LinePipe) while this thread parses and encodes it, and its output is written on another while
+// this thread goes on to the next Job.  The code cannot be written until the whole file has been
+// parsed, since the jumps are only sized then, so the writer overlaps one Job with the next.
+// next() gives the Jobs to run, until it gives NULL.
+//-----------------------------------------------------------------------------------------------
+template <typename F>
+static void Pipeline(F next, const Options &opts, AssemblyCache *cache)
+{
+    SpscRing<std::unique_ptr<Unit> > parsed(UNITS_WAITING);
+    Job *job;
+
+    // -- a full ring holds this thread back until the writer catches up; an empty Unit is the end
+    auto give = [&](std::unique_ptr<Unit> u) {
+        Backoff wait;
+        while (!parsed.TryPush(std::move(u))) wait.Pause();
+    };
+
+    std::thread writer([&]() {
+        std::unique_ptr<Unit> u;
+
+        for (;;) {
+            Backoff wait;
+            while (!parsed.TryPop(u)) wait.Pause();
+
+            if (!u) return;
+            Write(*u->job, *u->parser, opts, cache, u->key);
+        }
+    });
+
+    while ((job = next()) != NULL) {
+        std::unique_ptr<Unit> unit(new Unit);
+
+        unit->job = job;
+        unit->parser = Translate(*job, opts, cache, unit->key);
+        if (unit->parser) give(std::move(unit));
+    }
+
+    give(NULL);
+    writer.join();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Run() is one invocation of the assembler.  It parses the arguments and assembles the files
+// named in them on a pool of worker threads.  Each worker takes the next unclaimed Job until
+// there are none left; with -p, each worker is a Pipeline().  The diagnostics (and with --stats,
+// the Stats) are written to err once all the Jobs are done, as is the trace with --trace; the
+// outputs written are added to outputs, and the exit status is returned.  Relative names are from
+// cwd, unless it is empty.
+//-----------------------------------------------------------------------------------------------
+static int Run(const std::vector<std::string> &args, const std::string &cwd, std::ostream &err,
+        std::vector<std::string> &outputs)
+{
+    Options opts;
+    std::vector<Job> jobs;
+    std::vector<std::thread> pool;
+    std::atomic<size_t> nextJob(0);
+    Stats::Clock::time_point start = Stats::Clock::now();
+    int errors = 0;
+
+    opts.cwd = cwd;
+    opts.threads = std::thread::hardware_concurrency();
+    opts.pipeline = false;
+    opts.stats = false;
+    opts.format = FMT_ELF32;
+
+    for (size_t i = 0; i < args.size(); i ++) {
+        const char *arg = args[i].c_str();
+
+        if (arg[0] == '-' && arg[1] && strchr("foIjc", arg[1])) {
+            const char *val = arg + 2;
+
+            if (!arg[2]) val = (i + 1 < args.size() ? args[++ i].c_str() : NULL);
+
+            if (!val) {
+                Usage(err);
+                return 2;
+            }
+
+            switch (arg[1]) {
+            case 'f':
+                if (strcmp(val, "elf32") == 0 || strcmp(val, "elf") == 0) opts.format = FMT_ELF32;
+                else if (strcmp(val, "elf64") == 0) opts.format = FMT_ELF64;
+                else if (strcmp(val, "bin") == 0) opts.format = FMT_BIN;
+                else {
+                    err << "as-cent: unknown output format '" << val << "'" << std::endl;
+                    return 2;
+                }
+                break;
+
+            case 'o': opts.outDir = val; break;
+            case 'I': opts.includePaths.push_back(val); break;
+            case 'j': {
+                // -- strtoul() would take a sign or leading blanks, so the first has to be a digit
+                char *end;
+                unsigned long n = strtoul(val, &end, 10);
+
+                if (!isdigit((unsigned char)val[0]) || *end || n == 0 || n > UINT_MAX) {
+                    Usage(err);
+                    return 2;
+                }
+
+                opts.threads = (unsigned)n;
+                break;
+            }
+
+            case 'c': opts.cacheDir = val; break;
+            }
+        } else if (strcmp(arg, "-p") == 0) {
+            opts.pipeline = true;
+        } else if (strcmp(arg, "--stats") == 0) {
+            opts.stats = true;
+        } else if (strncmp(arg, "--trace=", 8) == 0 && arg[8]) {
+            opts.trace = arg + 8;
+        } else if (arg[0] == '-' && arg[1]) {
+            Usage(err);
+            return 2;
+        } else if (strcmp(arg, "-") == 0 && cwd != "") {
+            err << "as-cent: standard input cannot be assembled by the server" << std::endl;
+            return 2;
+        } else {
+            jobs.emplace_back();
+            jobs.back().input = (strcmp(arg, "-") == 0 ? "" : arg);
+            jobs.back().errors = 0;
+        }
+    }
+
+    if (jobs.empty()) {
+        Usage(err);
+        return 2;
+    }
+
+    for (size_t i = 0; i < jobs.size(); i ++) {
+        jobs[i].output = OutputName(jobs[i].input, opts);
+        if (opts.stats || opts.trace != "") jobs[i].stats.reset(new Stats);
+    }
+
+    std::unique_ptr<AssemblyCache> cache;
+    if (opts.cacheDir != "") {
+        cache.reset(new AssemblyCache(Where(opts.cacheDir, opts), CacheConfig(opts)));
+    }
+
+    if (opts.threads < 1) opts.threads = 1;
+
+    // -- with fewer files than threads, the threads left over lex the files ahead
+    opts.lexThreads = std::max(1u, opts.threads / (unsigned)jobs.size());
+    if (opts.threads > jobs.size()) opts.threads = (unsigned)jobs.size();
+
+    auto next = [&]() {
+        size_t j = nextJob ++;
+        return (j < jobs.size() ? &jobs[j] : (Job *)NULL);
+    };
+
+    auto worker = [&]() {
+        Job *job;
+
+        if (opts.pipeline) Pipeline(next, opts, cache.get());
+        else while ((job = next()) != NULL) Assemble(*job, opts, cache.get());
+    };
+
+    if (opts.threads == 1) worker();
+    else {
+        for (unsigned t = 0; t < opts.threads; t ++) pool.emplace_back(worker);
+        for (size_t t = 0; t < pool.size(); t ++) pool[t].join();
+    }
+
+    for (size_t i = 0; i < jobs.size(); i ++) {
+        err << jobs[i].diag.str();
+        errors += jobs[i].errors;
+        if (!jobs[i].errors) outputs.push_back(jobs[i].output);
+    }
+
+    if (opts.stats) {
+        for (size_t i = 0; i < jobs.size(); i ++) jobs[i].stats->Print(err, jobs[i].input);
+        err << "as-cent: stats: peak memory " << Stats::PeakMemory() << " KiB" << std::endl;
+    }
+
+    if (opts.trace != "") {
+        std::vector<const Stats *> stats;
+        std::vector<std::string> names;
+        std::ofstream trace(Where(opts.trace, opts).c_str());
+
+        for (size_t i = 0; i < jobs.size(); i ++) {
+            stats.push_back(jobs[i].stats.get());
+            names.push_back(jobs[i].input);
+        }
+
+        Stats::Trace(trace, start, stats, names);
+        trace.close();
+
+        if (!trace) {
+            err << "as-cent: unable to write the trace to " << opts.trace << std::endl;
+            errors ++;
+        }
+    }
+
+    if (cache) {
+        err << "as-cent: cache: " << cache->Hits() << " hits, " << cache->Misses() << " misses"
+                << std::endl;
+    }
+
+    return (errors ? 1 : 0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassemble() lists each file (a flat binary is taken to be loaded at base) on stdout, after
+// the round trip check if that was asked for.
+//-----------------------------------------------------------------------------------------------
+static int Disassemble(const std::vector<std::string> &files, uint32_t base, bool check)
+{
+    Disassembler dis;
+    int status = 0;
+
+    if (check) {
+        size_t checked;
+        size_t failed = dis.Check(std::cerr, checked);
+
+        std::cerr << "as-cent: round trip: " << checked << " encodings checked, " << failed
+                << " failed" << std::endl;
+        if (failed) status = 1;
+    }
+
+    for (size_t i = 0; i < files.size(); i ++) {
+        std::string out;
+
+        if (files[i][0] == '-') {
+            Usage(std::cerr);
+            return 2;
+        }
+
+        try {
+            dis.ListFile(files[i], base, out);
+        } catch (std::exception &e) {
+            std::cerr << "as-cent: " << e.what() << std::endl;
+            status = 1;
+            continue;
+        }
+
+        if (files.size() > 1) std::cout << (i ? "\n" : "") << files[i] << ":\n";
+        std::cout.write(out.data(), out.size());
+    }
+
+    std::cout.flush();
+    return status;
+}
+
+//-----------------------------------------------------------------------------------------------
+// main() is the main entry point.  `-S socket` makes this process a server, which Run()s each
+// request it is sent.  `-s socket` (or AS_CENT_SERVER in the environment) sends the rest of the
+// command line to a server instead, and only assembles here if none is listening or the files
+// are to be read from stdin.  `-d` and `-r` are always done here, by Disassemble().  Otherwise
+// the command line is simply Run() here.
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> args;
+    std::vector<std::string> outputs;
+    std::string serve;
+    std::string server = (getenv("AS_CENT_SERVER") ? getenv("AS_CENT_SERVER") : "");
+    bool input = false;                     // stdin is one of the files
+    bool disasm = false;
+    bool check = false;
+    uint32_t base = 0;
+    bool hasBase = false;
+
+    for (int i = 1; i < argc; i ++) {
+        std::string arg = argv[i];
+
+        if (arg.compare(0, 2, "-S") == 0 || arg.compare(0, 2, "-s") == 0) {
+            std::string val = (arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[++ i] : ""));
+
+            if (val == "") {
+                Usage(std::cerr);
+                return 2;
+            }
+
+            (arg[1] == 'S' ? serve : server) = val;
+            continue;
+        }
+
+        if (arg == "-d" || arg == "-r") {
+            (arg[1] == 'd' ? disasm : check) = true;
+            continue;
+        }
+
+        if (arg.compare(0, 2, "-b") == 0) {
+            std::string val = (arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[++ i] : ""));
+            char *end;
+
+            base = (uint32_t)strtoul(val.c_str(), &end, 0);
+            hasBase = true;
+            if (val == "" || *end) {
+                Usage(std::cerr);
+                return 2;
+            }
+
+            continue;
+        }
+
+        // -- the value of an option is passed on as it is, even if it looks like one of ours
+        if (arg.size() == 2 && arg[0] == '-' && strchr("foIjc", arg[1]) && i + 1 < argc) {
+            args.push_back(arg);
+            arg = argv[++ i];
+        } else if (arg == "-") input = true;
+
+        args.push_back(arg);
+    }
+
+    if (serve == "" && server != "" && !input && !disasm && !check) {
+        char cwd[PATH_MAX];
+        std::string diag;
+        int status;
+
+        if (getcwd(cwd, sizeof(cwd))
+                && AssemblyServer::Call(server, cwd, args, status, diag, outputs)) {
+            std::cerr << diag;
+            return status;
+        }
+    }
+
+    // -- the tables are built before any threads start; after this they are only ever read
+    if (!OpCodeInit()) {
+        std::cerr << "as-cent: the OpCodeTable is not grouped by mnemonic" << std::endl;
+        return 1;
+    }
+
+    if (disasm || check || hasBase) {
+        if (serve != "" || (disasm && args.empty()) || (hasBase && !disasm)) {
+            Usage(std::cerr);
+            return 2;
+        }
+
+        return Disassemble(args, base, check);
+    }
+
+    if (serve != "") {
+        if (!args.empty()) {
+            Usage(std::cerr);
+            return 2;
+        }
+
+        // -- the server keeps its include files for as long as it runs, so it keeps copies
+        FileStack::SetLongLived(true);
+        return AssemblyServer::Serve(serve, Run);
+    }
+
+    return Run(args, "", std::cerr, outputs);
 }
 
 //===============================================================================================
@@ -0,0 +1,805 @@
+//===============================================================================================
+// bench-asm.cc -- This file contains the assembler benchmark and its synthetic source generator.
+//
+// The sources are generated from the OpCodeTable rows themselves, so every 8086 form the table
+// has is exercised and the mix follows the table as it grows.  There are 4 mixes:
+//
+// * alu     -- every non-branch row, with registers, memory and immediates picked at random;
+// * branch  -- half branches (JMP, CALL, Jcc, LOOP, JCXZ) to labels behind and ahead, some far
+//              enough to be relaxed, with the rest ALU;
+// * macro   -- a handful of macros with parameters and a LOCAL label, used on most lines;
+// * include -- most of the lines come from a set of small files, each included many times.
+//
+// Each stage is timed on its own: the read (the FileStack, following the includes), the lexer,
+// the symbol and mnemonic lookups, and the encoder (over the instructions the generator chose)
+// are run as separate passes; the parse is what the whole Parser::Parse() takes beyond those; and
+// the emit is writing the output file.  Each pass is run -r times and the fastest kept.  The
+// results are written as one JSON object per mix, on a line of its own, so that runs can be
+// collected and compared over time.  With more than one mix, each is run by a bench-asm of its
+// own (started with the same options and just that -m), so its peak RSS is its own and not the
+// high-water mark of the mixes before it.
+//
+// With -t, the main file is also lexed ahead on that many threads (Lexer::LexLines()), timed on
+// its own as lex_ahead, and the parse pass lexes ahead the same way.  With -p, the parse pass
+// reads and lexes the main file on a pipeline instead (see LinePipe), and "pipeline" is true.
+//
+// It is not part of the assembler.  Build it against the assembler's own sources:
+//
+//     gcc -O2 -c OpCodeTable.c
+//     g++ -O2 -std=c++17 -pthread -o bench-asm bench-asm.cc OpCodeTable.o
+//             $(ls *.cc *.cpp | grep -v -e '^as-cent.cc$' -e '^bench-' -e '^test-')
+//     ./bench-asm [-m alu,branch,macro,include] [-n lines] [-r repeat] [-s seed]
+//             [-f bin|elf32|elf64] [-t threads] [-p] [-k]
+//
+// With -k the generated sources are kept (their directory is named on stderr), so they can be
+// given to as-cent itself.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-020   Initial version
+// 2026-10-16  ADCL   U-023   Added -t, to time lexing the main file ahead on several threads
+// 2026-10-16  ADCL   U-024   Added -p, to time the parse pass with the file read on a pipeline
+// 2026-10-16  ADCL   U-020   Each mix runs in a process of its own, so peak_rss_kb is its own
+//
+//===============================================================================================
+
+#include "OpCodeTable.h"
+#include "bin.hpp"
+#include "elf.hpp"
+#include "encoder.hpp"
+#include "filestack.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "symtab.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/resource.h>
+
+//-----------------------------------------------------------------------------------------------
+// These are the options.
+//-----------------------------------------------------------------------------------------------
+typedef enum {FMT_ELF32, FMT_ELF64, FMT_BIN} Format;
+
+struct Options {
+    std::vector<std::string> mixes;
+    size_t lines;
+    int repeat;
+    unsigned seed;
+    Format format;
+    unsigned threads;
+    bool pipeline;
+    bool keep;
+};
+
+//-----------------------------------------------------------------------------------------------
+// An Instr is an instruction the generator wrote, as the encoder is given it.
+//-----------------------------------------------------------------------------------------------
+struct Instr {
+    const OpCodeEntry *row;
+    Operand ops[3];
+};
+
+//-----------------------------------------------------------------------------------------------
+// A Workload is a generated source: the top-level file, the number of lines and bytes read to
+// assemble it (counting an included file each time it is included), and every instruction in it
+// (counting a macro's each time it is expanded).
+//-----------------------------------------------------------------------------------------------
+struct Workload {
+    std::string main;
+    std::vector<std::string> files;
+    size_t lines;
+    size_t bytes;
+    std::vector<Instr> instrs;
+};
+
+static const char INCLUDE[] = "\tinclude \"";
+static const size_t MACROS = 8;             // the macros in the macro mix
+static const size_t MACRO_LINES = 4;        // the instructions in each of them
+static const size_t INCLUDES = 32;          // the files in the include mix
+static const size_t INCLUDE_LINES = 64;     // the lines in each of them
+
+static volatile size_t sink;                // keeps the compiler from discarding the results
+
+//-----------------------------------------------------------------------------------------------
+// The Generator writes lines of source from the OpCodeTable rows, and the Instr for each one.
+//-----------------------------------------------------------------------------------------------
+class Generator {
+public:
+    Generator(unsigned seed);
+
+    bool Operand(OperandType t, std::string &text, ::Operand &op);
+    void Alu(std::string &text, Instr &ins);
+    void Branch(std::string &text, Instr &ins, const std::string &target);
+    bool HasNear(const OpCodeEntry *row) const;
+    size_t Pick(size_t n) { return (size_t)(rng() % n); };
+
+public:
+    std::vector<const OpCodeEntry *> alu;           // the rows without a relative operand
+    std::vector<const OpCodeEntry *> branch;        // the rows with one
+    std::vector<const OpCodeEntry *> macro;         // (r/m16, imm or r/m16) rows, for macro bodies
+
+private:
+    std::mt19937 rng;
+};
+
+static const char *reg8[] = {"al", "cl", "dl", "bl", "ah", "ch", "dh", "bh"};
+static const char *reg16[] = {"ax", "cx", "dx", "bx", "sp", "bp", "si", "di"};
+static const char *sreg[] = {"es", "cs", "ss", "ds"};
+
+//-----------------------------------------------------------------------------------------------
+// Generator::Generator(unsigned) sorts the 8086 rows into the ones it can write.
+//-----------------------------------------------------------------------------------------------
+Generator::Generator(unsigned seed) : rng(seed)
+{
+    for (size_t i = 0; i < OpCodeCount; i ++) {
+        const OpCodeEntry *r = &OpCodeTable[i];
+        std::string text;
+        ::Operand op;
+        bool ok = true;
+
+        if ((r->flags & ISA_CPU_MASK) != _8086 || !(r->flags & _16BITS)) continue;
+
+        if (r->type[0] == REL8 || r->type[0] == REL16) {
+            branch.push_back(r);
+            continue;
+        }
+
+        for (int k = 0; k < 3 && r->type[k] != OP_NONE; k ++) {
+            ok = ok && Operand(r->type[k], text, op);
+        }
+        if (!ok) continue;
+
+        alu.push_back(r);
+
+        if ((r->type[0] == R16 || r->type[0] == RM16) && r->type[2] == OP_NONE
+                && (r->type[1] == IMM8 || r->type[1] == IMM16 || r->type[1] == R16
+                    || r->type[1] == RM16)) {
+            macro.push_back(r);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Generator::Operand(OperandType, std::string&, Operand&) appends a random operand of type t to
+// text and sets op to match.  It returns false for a type it does not write.
+//-----------------------------------------------------------------------------------------------
+bool Generator::Operand(OperandType t, std::string &text, ::Operand &op)
+{
+    static const uint8_t bases[] = {R_BX, R_BX, R_BP, R_BP, R_NONE, R_NONE, R_BX};
+    static const uint8_t indexes[] = {R_SI, R_DI, R_SI, R_DI, R_SI, R_DI, R_NONE};
+    size_t m = Pick(sizeof(bases));
+    uint8_t r;
+
+    op = ::Operand();
+
+    switch (t) {
+    case RM8:
+    case RM16:
+        if (Pick(2)) return Operand(t == RM8 ? R8 : R16, text, op);
+        // fall through
+
+    case M: case M8: case M16: case M16_16:
+        op.cls = (t == M ? OC_MEM : (t == RM8 || t == M8) ? OC_MEM8
+                : t == M16_16 ? OC_MEM32 : OC_MEM16);
+        op.base = bases[m];
+        op.index = indexes[m];
+        op.value = 1 + Pick(100);
+        text += (op.cls == OC_MEM8 ? "byte ptr [" : op.cls == OC_MEM16 ? "word ptr [" :
+                op.cls == OC_MEM32 ? "dword ptr [" : "[");
+        if (op.base != R_NONE) text += std::string(reg16[RegCode(op.base)]) + "+";
+        if (op.index != R_NONE) text += std::string(reg16[RegCode(op.index)]) + "+";
+        text += std::to_string(op.value) + "]";
+        return true;
+
+    case R8:
+        r = (uint8_t)Pick(8);
+        op.cls = OC_AL + r;
+        op.reg = R_AL + r;
+        text += reg8[r];
+        return true;
+
+    case R16:
+        r = (uint8_t)Pick(8);
+        op.cls = OC_AX + r;
+        op.reg = R_AX + r;
+        text += reg16[r];
+        return true;
+
+    case SREG:
+        r = (uint8_t)(Pick(3) == 0 ? 0 : 2 + Pick(2));          // not CS
+        op.cls = OC_ES + r;
+        op.reg = R_ES + r;
+        text += sreg[r];
+        return true;
+
+    case REG_AL: case REG_CL: case REG_AX: case REG_CX: case REG_DX: case REG_BX: case REG_SP:
+    case REG_BP: case REG_SI: case REG_DI:
+        r = (uint8_t)(t == REG_AL ? R_AL : t == REG_CL ? R_CL
+                : R_AX + (t == REG_AX ? 0 : t == REG_CX ? 1 : t == REG_DX ? 2 : t == REG_BX ? 3
+                : t == REG_SP ? 4 : t == REG_BP ? 5 : t == REG_SI ? 6 : 7));
+        op.cls = OC_AL + r;
+        op.reg = r;
+        text += (IsReg8(r) ? reg8[RegCode(r)] : reg16[RegCode(r)]);
+        return true;
+
+    case REG_CS: case REG_DS: case REG_ES: case REG_SS:
+        r = (t == REG_ES ? R_ES : t == REG_CS ? R_CS : t == REG_SS ? R_SS : R_DS);
+        op.cls = OC_ES + (r - R_ES);
+        op.reg = r;
+        text += sreg[r - R_ES];
+        return true;
+
+    case ONE:
+        op.cls = OC_ONE;
+        op.value = 1;
+        text += "1";
+        return true;
+
+    case IMM8:
+    case IMM16:
+        op.value = (t == IMM8 ? 2 + Pick(126) : 300 + Pick(30000));
+        op.cls = ImmediateClass(op.value);
+        text += std::to_string(op.value);
+        return true;
+
+    case MOFFS8:
+    case MOFFS16:
+        op.cls = (t == MOFFS8 ? OC_MOFFS8 : OC_MOFFS16);
+        op.value = 256 + Pick(30000);
+        text += (t == MOFFS8 ? "byte ptr [" : "word ptr [") + std::to_string(op.value) + "]";
+        return true;
+
+    case PTR16_16:
+        op.cls = OC_FAR;
+        op.segment = (uint16_t)(256 + Pick(30000));
+        op.value = Pick(30000);
+        text += std::to_string(op.segment) + ":" + std::to_string(op.value);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// MnemonicName() is the name of a row's mnemonic, in lower case.
+//-----------------------------------------------------------------------------------------------
+static std::string MnemonicName(const OpCodeEntry *row)
+{
+    std::string s(row->mnemonic->name, strnlen(row->mnemonic->name, sizeof(row->mnemonic->name)));
+
+    for (size_t i = 0; i < s.size(); i ++) s[i] = (char)tolower((unsigned char)s[i]);
+    return s;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Generator::Alu(std::string&, Instr&) writes a line from a random non-branch row.
+//-----------------------------------------------------------------------------------------------
+void Generator::Alu(std::string &text, Instr &ins)
+{
+    ins = Instr();
+    ins.row = alu[Pick(alu.size())];
+    text = "\t" + MnemonicName(ins.row);
+
+    for (int k = 0; k < 3 && ins.row->type[k] != OP_NONE; k ++) {
+        text += (k ? ", " : "\t");
+        Operand(ins.row->type[k], text, ins.ops[k]);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Generator::Branch(std::string&, Instr&, const std::string&) writes a branch to target, from a
+// branch row already in ins.  The target is only a label as far as the encoder is concerned.
+//-----------------------------------------------------------------------------------------------
+void Generator::Branch(std::string &text, Instr &ins, const std::string &target)
+{
+    text = "\t" + MnemonicName(ins.row) + "\t" + target;
+    ins.ops[0] = ins.ops[1] = ins.ops[2] = ::Operand();
+    ins.ops[0].cls = OC_IMM16;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Generator::HasNear(const OpCodeEntry*) is whether a branch can reach beyond the short range:
+// only LOOP and JCXZ cannot.
+//-----------------------------------------------------------------------------------------------
+bool Generator::HasNear(const OpCodeEntry *row) const
+{
+    std::string mn = MnemonicName(row);
+    return mn.compare(0, 4, "loop") != 0 && mn != "jcxz";
+}
+
+//-----------------------------------------------------------------------------------------------
+// Output is a file being generated.  Add() counts each line toward the workload.
+//-----------------------------------------------------------------------------------------------
+struct Output {
+    std::ofstream out;
+    size_t lines;
+    size_t bytes;
+
+    Output(const std::string &path) : out(path), lines(0), bytes(0) {};
+    void Add(const std::string &line) { out << line << '\n'; lines ++; bytes += line.size() + 1; };
+};
+
+//-----------------------------------------------------------------------------------------------
+// Generate() writes the source for a mix, of about n lines, into dir.
+//-----------------------------------------------------------------------------------------------
+static Workload Generate(Generator &gen, const std::string &mix, size_t n, const std::string &dir)
+{
+    Workload w;
+    std::string text;
+    Instr ins;
+
+    w.lines = w.bytes = 0;
+    w.main = dir + "/" + mix + ".asm";
+    w.files.push_back(w.main);
+
+    Output src(w.main);
+
+    if (mix == "alu") {
+        while (src.lines < n) {
+            gen.Alu(text, ins);
+            src.Add(text);
+            w.instrs.push_back(ins);
+        }
+    } else if (mix == "branch") {
+        size_t labels = 0;          // the labels defined so far, L0 up
+        size_t ahead = 0;           // the labels referred to so far
+
+        while (src.lines < n) {
+            if (gen.Pick(4) == 0) src.Add("L" + std::to_string(labels ++) + ":");
+
+            if (gen.Pick(2)) {
+                gen.Alu(text, ins);
+            } else {
+                ins.row = gen.branch[gen.Pick(gen.branch.size())];
+
+                if (!gen.HasNear(ins.row)) {
+                    // -- back to a label just before it, so it is always in range
+                    src.Add("L" + std::to_string(labels ++) + ":");
+                    gen.Branch(text, ins, "L" + std::to_string(labels - 1));
+                } else {
+                    // -- near or far, behind or ahead; a far one will be relaxed
+                    size_t span = (gen.Pick(8) == 0 ? 400 : 20);
+                    size_t t = labels + gen.Pick(span);
+                    t = (t > span / 2 ? t - span / 2 : 0);
+                    ahead = std::max(ahead, t + 1);
+                    gen.Branch(text, ins, "L" + std::to_string(t));
+                }
+            }
+
+            src.Add(text);
+            w.instrs.push_back(ins);
+        }
+
+        while (labels < ahead) src.Add("L" + std::to_string(labels ++) + ":");
+    } else if (mix == "macro") {
+        static const char name[sizeof(::Mnemonic)] = "JNE";     // MakeMnemonicN() loads 16 bytes
+        size_t count;
+        const OpCodeEntry *jne = OpCodeLookup(MakeMnemonicN(name, 3), &count);
+        std::vector<std::vector<Instr>> bodies(MACROS);
+        std::string p2;
+
+        for (size_t m = 0; m < MACROS; m ++) {
+            src.Add("m" + std::to_string(m) + "\tmacro\tp1, p2");
+            src.Add("\tlocal\tdone");
+            src.Add("\tjne\tdone");
+
+            for (size_t k = 0; k < MACRO_LINES; k ++) {
+                Instr b = Instr();
+
+                b.row = gen.macro[gen.Pick(gen.macro.size())];
+                text = "\t" + MnemonicName(b.row) + "\tp1, ";
+                if (b.row->type[1] == IMM8 || b.row->type[1] == IMM16) text += "p2";
+                else gen.Operand(R16, text, b.ops[1]);
+
+                src.Add(text);
+                bodies[m].push_back(b);
+            }
+
+            src.Add("done:");
+            src.Add("\tendm");
+        }
+
+        while (src.lines < n) {
+            if (gen.Pick(5) == 0) {
+                gen.Alu(text, ins);
+                src.Add(text);
+                w.instrs.push_back(ins);
+                continue;
+            }
+
+            // -- a use: the arguments are a register and an immediate
+            size_t m = gen.Pick(MACROS);
+            ::Operand p1, imm;
+            text = "\tm" + std::to_string(m) + "\t";
+            gen.Operand(R16, text, p1);
+            text += ", ";
+            gen.Operand(IMM16, text, imm);
+            src.Add(text);
+
+            ins.row = jne;
+            gen.Branch(text, ins, "done");
+            w.instrs.push_back(ins);
+
+            for (size_t k = 0; k < MACRO_LINES; k ++) {
+                Instr b = bodies[m][k];
+
+                b.ops[0] = p1;
+                if (b.row->type[1] == IMM8 || b.row->type[1] == IMM16) b.ops[1] = imm;
+                w.instrs.push_back(b);
+            }
+        }
+    } else if (mix == "include") {
+        std::vector<std::vector<Instr>> incs(INCLUDES);
+        std::vector<size_t> bytes(INCLUDES);
+
+        for (size_t f = 0; f < INCLUDES; f ++) {
+            std::string name = mix + "-" + std::to_string(f) + ".inc";
+            Output inc(dir + "/" + name);
+
+            w.files.push_back(dir + "/" + name);
+
+            for (size_t k = 0; k < INCLUDE_LINES; k ++) {
+                gen.Alu(text, ins);
+                inc.Add(text);
+                incs[f].push_back(ins);
+            }
+
+            bytes[f] = inc.bytes;
+        }
+
+        // -- a few lines of its own, then a file; the file's lines are counted as they are read
+        while (src.lines + w.lines < n) {
+            if (gen.Pick(9)) {
+                gen.Alu(text, ins);
+                src.Add(text);
+                w.instrs.push_back(ins);
+            } else {
+                size_t f = gen.Pick(INCLUDES);
+
+                src.Add(INCLUDE + mix + "-" + std::to_string(f) + ".inc\"");
+                w.lines += INCLUDE_LINES;
+                w.bytes += bytes[f];
+                w.instrs.insert(w.instrs.end(), incs[f].begin(), incs[f].end());
+            }
+        }
+    } else {
+        throw std::runtime_error("unknown mix '" + mix + "'");
+    }
+
+    w.lines += src.lines;
+    w.bytes += src.bytes;
+    return w;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Time() runs func repeat times and returns the fastest, in seconds.
+//-----------------------------------------------------------------------------------------------
+template <typename F>
+static double Time(int repeat, F func)
+{
+    double best = 0;
+
+    for (int i = 0; i < repeat; i ++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (i == 0 || elapsed.count() < best) best = elapsed.count();
+    }
+
+    return best;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Read() reads the lines of a workload through a FileStack, following the includes, and hands
+// each to func.  It is the first part of every pass.
+//-----------------------------------------------------------------------------------------------
+template <typename F>
+static void Read(const Workload &w, F func)
+{
+    FileStack files;
+    std::string_view line;
+
+    files.Push(w.main);
+
+    while (files.ReadLine(line)) {
+        if (line.compare(0, sizeof(INCLUDE) - 1, INCLUDE) == 0) {
+            std::string_view name = line.substr(sizeof(INCLUDE) - 1);
+            files.Push(std::string(name.substr(0, name.find('"'))));
+        } else func(line);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stage() writes the JSON for one stage.
+//-----------------------------------------------------------------------------------------------
+static void Stage(std::ostream &out, const char *name, double s, const Workload &w)
+{
+    out << "{\"stage\":\"" << name << "\",\"seconds\":" << s
+            << ",\"lines_per_s\":" << (s > 0 ? w.lines / s : 0)
+            << ",\"bytes_per_s\":" << (s > 0 ? w.bytes / s : 0) << "}";
+}
+
+//-----------------------------------------------------------------------------------------------
+// Run() times the stages for one workload and writes its results.
+//-----------------------------------------------------------------------------------------------
+static void Run(const std::string &mix, const Workload &w, const Options &opts,
+        const std::string &dir)
+{
+    std::string output = dir + "/" + mix + (opts.format == FMT_BIN ? ".bin" : ".o");
+    std::vector<Token> tokens;
+    Lexer lexer;
+    size_t outputBytes = 0;
+    double emit = 0;
+
+    double read = Time(opts.repeat, [&]() {
+        size_t n = 0;
+        Read(w, [&](std::string_view line) { n += line.size(); });
+        sink = n;
+    });
+
+    double lex = Time(opts.repeat, [&]() {
+        size_t n = 0;
+        Read(w, [&](std::string_view line) {
+            tokens.clear();
+            lexer.Lex(line, tokens);
+            n += tokens.size();
+        });
+        sink = n;
+    });
+
+    double lookup = Time(opts.repeat, [&]() {
+        SymbolTable symTab;
+        size_t n = 0, count;
+
+        InitSymbols(symTab);
+
+        Read(w, [&](std::string_view line) {
+            tokens.clear();
+            lexer.Lex(line, tokens);
+
+            for (size_t i = 0; i < tokens.size(); i ++) {
+                std::string_view s = Lexer::Text(line, tokens[i]);
+
+                if (tokens[i].type == TOK_MNEMONIC) {
+                    if (OpCodeLookup(MakeMnemonicN(s.data(), s.size()), &count)) n += count;
+                    else n += (symTab.Lookup(s) != NULL);
+                } else if (tokens[i].type == TOK_IDENT || tokens[i].type == TOK_LABEL) {
+                    if (!symTab.Lookup(s)) symTab.Insert(s);
+                    n ++;
+                }
+            }
+        });
+
+        sink = n;
+    });
+
+    double lexAhead = 0;
+
+    if (opts.threads > 1) {
+        std::shared_ptr<const MappedFile> f = MappedFile::Open(w.main);
+
+        lexAhead = Time(opts.repeat, [&]() {
+            LexedText lexed;
+            lexer.LexLines(std::string_view(f->Data(), f->Size()), opts.threads, lexed);
+            sink = lexed.lines[lexed.lineCount];
+        });
+    }
+
+    double encode = Time(opts.repeat, [&]() {
+        uint8_t buf[Encoder::MAX_LENGTH];
+        uint32_t address = 0;
+
+        for (size_t i = 0; i < w.instrs.size(); i ++) {
+            address += (uint32_t)Encoder::Encode(w.instrs[i].row, w.instrs[i].ops, address, buf);
+        }
+
+        sink = address;
+    });
+
+    double parse = Time(opts.repeat, [&]() {
+        std::ostringstream diag;
+        Parser parser(w.main, diag);
+
+        InitSymbols(parser.Symbols());
+        parser.SetLexThreads(opts.threads);
+        parser.SetPipeline(opts.pipeline);
+        parser.AllowExternals(opts.format != FMT_BIN);
+        parser.Parse();
+
+        if (parser.Errors()) {
+            throw std::runtime_error("the " + mix + " source has errors:\n" + diag.str());
+        }
+
+        // -- the emit is timed on its own, but needs this parse
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if (opts.format == FMT_BIN) BinWriter::Write(output, parser.Code());
+        else {
+            ElfWriter::ElfClass cls = ElfWriter::ELF32;
+
+            if (opts.format == FMT_ELF64) cls = ElfWriter::ELF64;
+            ElfWriter::Write(output, cls, w.main, parser.Code(), parser.Labels(), parser.Relocs(),
+                    parser.Symbols());
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (emit == 0 || elapsed.count() < emit) emit = elapsed.count();
+        outputBytes = parser.Code().Size();
+    });
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+
+    // -- the passes are cumulative; each stage is what its pass adds to the one before
+    parse -= emit;
+    double stages[] = {read, std::max(0.0, lex - read), std::max(0.0, lookup - lex), encode,
+            std::max(0.0, parse - lookup - encode), emit};
+    const char *names[] = {"read", "lex", "lookup", "encode", "parse", "emit"};
+
+    std::cout.precision(6);
+    std::cout << "{\"mix\":\"" << mix << "\",\"seed\":" << opts.seed << ",\"lines\":" << w.lines
+            << ",\"bytes\":" << w.bytes << ",\"instructions\":" << w.instrs.size()
+            << ",\"output_bytes\":" << outputBytes
+            << ",\"pipeline\":" << (opts.pipeline ? "true" : "false")
+            << ",\"stages\":[";
+
+    for (size_t i = 0; i < sizeof(stages) / sizeof(stages[0]); i ++) {
+        if (i) std::cout << ",";
+        Stage(std::cout, names[i], stages[i], w);
+    }
+
+    std::cout << "],";
+
+    if (opts.threads > 1) {
+        std::cout << "\"lex_ahead\":{\"threads\":" << opts.threads << ",\"time\":";
+        Stage(std::cout, "lex_ahead", lexAhead, w);
+        std::cout << "},";
+    }
+
+    std::cout << "\"total\":";
+    Stage(std::cout, "total", parse + emit, w);
+    std::cout << ",\"peak_rss_kb\":" << ru.ru_maxrss << "}" << std::endl;
+
+    if (!opts.keep) unlink(output.c_str());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Usage() prints the command line help.
+//-----------------------------------------------------------------------------------------------
+static void Usage(void)
+{
+    std::cerr << "usage: bench-asm [-m alu,branch,macro,include] [-n lines] [-r repeat] [-s seed] "
+            "[-f bin|elf32|elf64] [-t threads] [-p] [-k]" << std::endl;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Quote() makes s a single word for the shell.
+//-----------------------------------------------------------------------------------------------
+static std::string Quote(const std::string &s)
+{
+    std::string q = "'";
+
+    for (size_t i = 0; i < s.size(); i ++) {
+        if (s[i] == '\'') q += "'\\''";
+        else q += s[i];
+    }
+
+    return q + "'";
+}
+
+//-----------------------------------------------------------------------------------------------
+// main() is the benchmark entry point.
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    Options opts;
+    std::string mixes = "alu,branch,macro,include";
+    char dir[] = "/tmp/bench-asm.XXXXXX";
+    int c;
+
+    opts.lines = 200000;
+    opts.repeat = 3;
+    opts.seed = 1;
+    opts.format = FMT_BIN;
+    opts.threads = 1;
+    opts.pipeline = false;
+    opts.keep = false;
+
+    while ((c = getopt(argc, argv, "m:n:r:s:f:t:pk")) != -1) {
+        switch (c) {
+        case 'm': mixes = optarg; break;
+        case 'n': opts.lines = (size_t)atol(optarg); break;
+        case 'r': opts.repeat = std::max(1, atoi(optarg)); break;
+        case 's': opts.seed = (unsigned)atol(optarg); break;
+        case 't': opts.threads = (unsigned)std::max(1, atoi(optarg)); break;
+        case 'p': opts.pipeline = true; break;
+        case 'k': opts.keep = true; break;
+
+        case 'f':
+            if (strcmp(optarg, "elf32") == 0) opts.format = FMT_ELF32;
+            else if (strcmp(optarg, "elf64") == 0) opts.format = FMT_ELF64;
+            else if (strcmp(optarg, "bin") == 0) opts.format = FMT_BIN;
+            else {
+                Usage();
+                return 2;
+            }
+            break;
+
+        default:
+            Usage();
+            return 2;
+        }
+    }
+
+    for (size_t at = 0; at <= mixes.size(); ) {
+        size_t comma = std::min(mixes.find(',', at), mixes.size());
+        if (comma > at) opts.mixes.push_back(mixes.substr(at, comma - at));
+        at = comma + 1;
+    }
+
+    // -- ru_maxrss never goes down, so each of several mixes is run by a process of its own
+    if (opts.mixes.size() > 1) {
+        int rc = 0;
+
+        std::cout.flush();
+
+        for (size_t i = 0; i < opts.mixes.size(); i ++) {
+            std::string cmd;
+
+            for (int a = 0; a < argc; a ++) cmd += Quote(argv[a]) + " ";
+            if (system((cmd + "-m " + Quote(opts.mixes[i])).c_str()) != 0) rc = 1;
+        }
+
+        return rc;
+    }
+
+    if (opts.mixes.empty()) {
+        Usage();
+        return 2;
+    }
+
+    if (!OpCodeInit()) {
+        std::cerr << "bench-asm: the OpCodeTable is not grouped by mnemonic" << std::endl;
+        return 1;
+    }
+
+    if (!mkdtemp(dir)) {
+        std::cerr << "bench-asm: unable to create a directory for the sources" << std::endl;
+        return 1;
+    }
+
+    int rc = 0;
+
+    try {
+        Generator gen(opts.seed);
+        Workload w = Generate(gen, opts.mixes[0], opts.lines, dir);
+
+        Run(opts.mixes[0], w, opts, dir);
+        if (!opts.keep) for (size_t f = 0; f < w.files.size(); f ++) unlink(w.files[f].c_str());
+    } catch (std::exception &e) {
+        std::cerr << "bench-asm: " << e.what() << std::endl;
+        rc = 1;
+    }
+
+    if (opts.keep) std::cerr << "bench-asm: the sources are in " << dir << std::endl;
+    else rmdir(dir);
+
+    return rc;
+}
+
+//===============================================================================================
@@ -0,0 +1,86 @@
+//===============================================================================================
+// bench-utils.cc -- This file contains a micro-benchmark comparing the std::string and the
+// std::string_view versions of ltrim(), rtrim(), and trim().
+//
+// It is not part of the assembler.  Build and run it on its own:
+//
+//     g++ -O2 -std=c++17 bench-utils.cc -o bench-utils && ./bench-utils [iterations]
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+//
+//===============================================================================================
+
+#include "utils.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// These are representative source lines -- including the all-whitespace case that used to throw.
+//-----------------------------------------------------------------------------------------------
+static const char *sampleLines[] = {
+    "start:  mov     ax, 0x07c0              ; set up the data segment   ",
+    "        add     byte ptr [bx+si+4], 0x12",
+    "        jmp     short start",
+    "loop1:",
+    "        ; just a comment",
+    "\t\t    \t",
+    "",
+    "        int     0x10\r",
+};
+
+static volatile size_t sink;            // keeps the compiler from discarding the results
+
+//-----------------------------------------------------------------------------------------------
+// Time() runs func over all the sample lines iterations times and reports ns per call.
+//-----------------------------------------------------------------------------------------------
+template <typename F>
+static void Time(const char *name, long iterations, const std::vector<std::string> &lines, F func)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t total = 0;
+
+    for (long i = 0; i < iterations; i ++) {
+        for (size_t j = 0; j < lines.size(); j ++) total += func(lines[j]);
+    }
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = total;
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(10)
+            << std::fixed << std::setprecision(2)
+            << elapsed.count() / (iterations * lines.size()) << " ns/call" << std::endl;
+}
+
+//-----------------------------------------------------------------------------------------------
+// main() is the benchmark entry point.
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    long iterations = (argc > 1 ? atol(argv[1]) : 1000000);
+    size_t count = sizeof(sampleLines) / sizeof(sampleLines[0]);
+    std::vector<std::string> lines(sampleLines, sampleLines + count);
+
+    Time("rtrim(std::string)", iterations, lines,
+            [](const std::string &s) { return rtrim(s).size(); });
+    Time("rtrim(string_view)", iterations, lines,
+            [](const std::string &s) { return rtrim(std::string_view(s)).size(); });
+    Time("ltrim(std::string)", iterations, lines,
+            [](const std::string &s) { return ltrim(s).size(); });
+    Time("ltrim(string_view)", iterations, lines,
+            [](const std::string &s) { return ltrim(std::string_view(s)).size(); });
+    Time("trim(std::string)", iterations, lines,
+            [](const std::string &s) { return trim(s).size(); });
+    Time("trim(string_view)", iterations, lines,
+            [](const std::string &s) { return trim(std::string_view(s)).size(); });
+
+    return 0;
+}
+
+//===============================================================================================
@@ -0,0 +1,27 @@
+//===============================================================================================
+// bin.cc -- This file contains the class implementation for writing a flat binary image.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-015   Initial version
+// 2026-10-16  ADCL   U-014   Commit() the OutputFile once it is written
+//
+//===============================================================================================
+
+#include "bin.hpp"
+#include "out-file.hpp"
+
+#include <cstring>
+
+//-----------------------------------------------------------------------------------------------
+// BinWriter::Write(const std::string&, const Section&) writes the image for text to path.
+//-----------------------------------------------------------------------------------------------
+void BinWriter::Write(const std::string &path, const Section &text)
+{
+    OutputFile out(path, text.Size());
+
+    if (text.Size()) memcpy(out.At<uint8_t>(0), text.Data(), text.Size());
+    out.Commit();
+}
+
+//===============================================================================================
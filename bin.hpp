@@ -0,0 +1,37 @@
+//===============================================================================================
+// bin.hpp -- This file contains the class definition for writing a flat binary image.
+//
+// A flat binary is the code and nothing else -- a boot sector or a real mode image, loaded at a
+// fixed address that is given to the assembler with ORG.  The addresses were already worked out
+// from the ORG by the Relaxer, so there is nothing left to relocate: the image is the section,
+// written once into an OutputFile of exactly its size.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-015   Initial version
+//
+//===============================================================================================
+
+#ifndef __BIN_HPP__
+#define __BIN_HPP__
+
+#ifndef __cplusplus
+#error The file 'bin.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "section.hpp"
+
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// The BinWriter class has no state.  Write() throws std::ios_base::failure if the file cannot be
+// created.
+//-----------------------------------------------------------------------------------------------
+class BinWriter {
+public:
+    static void Write(const std::string &path, const Section &text);
+};
+
+//===============================================================================================
+
+#endif
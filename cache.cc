@@ -0,0 +1,199 @@
+//===============================================================================================
+// cache.cc -- This file contains the class implementation for the on-disk assembly cache.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-019   Initial version
+//
+//===============================================================================================
+
+#include "cache.hpp"
+#include "in-file.hpp"
+#include "utils.hpp"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+//-----------------------------------------------------------------------------------------------
+// Hash128() is 2 differently seeded HashBytes() of the same data.
+//-----------------------------------------------------------------------------------------------
+static void Hash128(const void *data, size_t len, uint64_t h[2])
+{
+    h[0] = HashBytes(data, len, 0);
+    h[1] = HashBytes(data, len, 0x243f6a8885a308d3ull);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hex() spells a 128-bit key as 32 hex digits, for a file name.
+//-----------------------------------------------------------------------------------------------
+static std::string Hex(const uint64_t h[2])
+{
+    char buf[33];
+
+    snprintf(buf, sizeof(buf), "%016llx%016llx", (unsigned long long)h[0],
+            (unsigned long long)h[1]);
+    return buf;
+}
+
+//-----------------------------------------------------------------------------------------------
+// HashFile() adds the hash of a file's path and contents to parts.  It returns false if the file
+// cannot be read.
+//-----------------------------------------------------------------------------------------------
+static bool HashFile(const std::string &path, std::vector<uint64_t> &parts)
+{
+    uint64_t h[2];
+
+    try {
+        std::shared_ptr<const MappedFile> f = MappedFile::Open(path);
+
+        Hash128(path.data(), path.size(), h);
+        parts.insert(parts.end(), h, h + 2);
+        Hash128(f->Data(), f->Size(), h);
+        parts.insert(parts.end(), h, h + 2);
+    } catch (std::exception &) {
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyCache::AssemblyCache(const std::string&, const std::string&) opens (creating, if need
+// be) the cache in directory d, for the configuration config.
+//-----------------------------------------------------------------------------------------------
+AssemblyCache::AssemblyCache(const std::string &d, const std::string &cfg)
+        : dir(d), hits(0), misses(0), tmpCount(0)
+{
+    mkdir(dir.c_str(), 0777);
+    Hash128(cfg.data(), cfg.size(), config);
+}
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyCache::Fetch(const std::string&, const std::string&, Key&) looks up the output for
+// input, and if it is in the cache puts it at output.
+//-----------------------------------------------------------------------------------------------
+bool AssemblyCache::Fetch(const std::string &input, const std::string &output, Key &key)
+{
+    std::vector<uint64_t> parts(config, config + 2);
+    char canon[PATH_MAX];
+
+    if (!realpath(input.c_str(), canon) || !HashFile(canon, parts)) {
+        throw std::ios_base::failure("Unable to open file " + input);
+    }
+
+    Hash128(parts.data(), parts.size() * sizeof(uint64_t), key.base);
+    key.manifest = dir + "/" + Hex(key.base) + ".m";
+
+    // -- the manifest is the canonical path of each include, one per line
+    std::ifstream manifest(key.manifest);
+    std::string path;
+
+    parts.clear();
+
+    if (!manifest) {
+        misses ++;
+        return false;
+    }
+
+    while (std::getline(manifest, path)) {
+        if (!HashFile(path, parts)) {
+            misses ++;
+            return false;
+        }
+    }
+
+    if (!Install(Entry(key, parts), output)) {
+        misses ++;
+        return false;
+    }
+
+    hits ++;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyCache::Store(const Key&, const std::vector<std::string>&, const std::string&) adds the
+// output just written for key, with the canonical paths of the files it included.  The output
+// goes in first, so a manifest never leads to an output that is not there.
+//-----------------------------------------------------------------------------------------------
+void AssemblyCache::Store(const Key &key, const std::vector<std::string> &includes,
+        const std::string &output)
+{
+    std::vector<uint64_t> parts;
+    std::string tmp = dir + "/tmp." + std::to_string(getpid()) + "." + std::to_string(tmpCount ++);
+
+    for (size_t i = 0; i < includes.size(); i ++) {
+        if (!HashFile(includes[i], parts)) return;
+    }
+
+    if (!Install(output, tmp) || rename(tmp.c_str(), Entry(key, parts).c_str()) < 0) {
+        unlink(tmp.c_str());
+        return;
+    }
+
+    std::ofstream manifest(tmp, std::ios::trunc);
+
+    for (size_t i = 0; i < includes.size(); i ++) manifest << includes[i] << '\n';
+    manifest.close();
+
+    if (!manifest || rename(tmp.c_str(), key.manifest.c_str()) < 0) unlink(tmp.c_str());
+}
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyCache::Entry(const Key&, const std::vector<uint64_t>&) is the path of the output for
+// key, given the hashes of the includes.
+//-----------------------------------------------------------------------------------------------
+std::string AssemblyCache::Entry(const Key &key, const std::vector<uint64_t> &parts) const
+{
+    std::vector<uint64_t> all(key.base, key.base + 2);
+    uint64_t h[2];
+
+    all.insert(all.end(), parts.begin(), parts.end());
+    Hash128(all.data(), all.size() * sizeof(uint64_t), h);
+
+    return dir + "/" + Hex(h) + ".out";
+}
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyCache::Install(const std::string&, const std::string&) replaces to with from: a hard
+// link if it can be, otherwise a copy.
+//-----------------------------------------------------------------------------------------------
+bool AssemblyCache::Install(const std::string &from, const std::string &to) const
+{
+    char buf[65536];
+    ssize_t n = 0;
+
+    unlink(to.c_str());
+    if (link(from.c_str(), to.c_str()) == 0) return true;
+
+    int in = open(from.c_str(), O_RDONLY);
+    if (in < 0) return false;
+
+    int out = open(to.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0666);
+    if (out < 0) {
+        close(in);
+        return false;
+    }
+
+    while ((n = read(in, buf, sizeof(buf))) > 0) {
+        if (write(out, buf, n) != n) {
+            n = -1;
+            break;
+        }
+    }
+
+    close(in);
+    if (close(out) < 0) n = -1;
+    if (n < 0) unlink(to.c_str());
+
+    return n == 0;
+}
+
+//===============================================================================================
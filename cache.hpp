@@ -0,0 +1,88 @@
+//===============================================================================================
+// cache.hpp -- This file contains the class definition for the on-disk assembly cache.
+//
+// With `-c dir`, each output file is also kept in dir, under a hash of everything that went into
+// it, and a later run that would produce the same output copies it back instead of assembling.
+// What goes into an output is:
+//
+// * the assembler itself and its options (the version, the format, the include paths, the
+//   initial ISA -- passed in as a single configuration string);
+// * the source file, by its canonical path and its contents; and
+// * every file it included, by canonical path and contents.
+//
+// The CPU and BITS state is set by directives, so it is covered by the contents of the files.
+//
+// Which files are included is only known after a file is assembled, so a lookup takes 2 steps,
+// the way ccache does it.  The first key (from the configuration and the source) names a
+// manifest, which lists the includes the source had last time.  The second key adds the contents
+// of those includes and names the output.  If an include has changed, or the source now includes
+// something else, the second key will not be found, and the manifest is replaced once the file
+// has been assembled again.
+//
+// The keys are 128 bits, from 2 differently seeded HashBytes() over each part.  Every file in
+// the cache is written under a temporary name and renamed into place, so several processes (or
+// threads) may share a cache.  An output is hard-linked between the cache and its destination
+// when they are on the same file system, and copied otherwise; the OutputFile always replaces
+// its path rather than writing through it, so a linked output is never changed in the cache.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-019   Initial version
+//
+//===============================================================================================
+
+#ifndef __CACHE_HPP__
+#define __CACHE_HPP__
+
+#ifndef __cplusplus
+#error The file 'cache.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The AssemblyCache class.  Fetch() returns true and puts the cached output at output on a hit;
+// on a miss, the caller assembles the file and passes the same Key to Store().  Fetch() throws
+// std::ios_base::failure if the source cannot be read; the cache itself is only an optimization,
+// so any other failure is a miss, and Store() never throws.
+//-----------------------------------------------------------------------------------------------
+class AssemblyCache {
+public:
+    struct Key {
+        uint64_t base[2];           // the configuration and the source
+        std::string manifest;       // the path of the manifest for base
+    };
+
+public:
+    AssemblyCache(const std::string &d, const std::string &config);
+    virtual ~AssemblyCache() {};
+
+private:
+    AssemblyCache(const AssemblyCache &);
+    AssemblyCache &operator=(const AssemblyCache &);
+
+public:
+    bool Fetch(const std::string &input, const std::string &output, Key &key);
+    void Store(const Key &key, const std::vector<std::string> &includes, const std::string &output);
+
+    size_t Hits(void) const { return hits; };
+    size_t Misses(void) const { return misses; };
+
+private:
+    std::string Entry(const Key &key, const std::vector<uint64_t> &parts) const;
+    bool Install(const std::string &from, const std::string &to) const;
+
+private:
+    std::string dir;
+    uint64_t config[2];
+    std::atomic<size_t> hits;
+    std::atomic<size_t> misses;
+    std::atomic<unsigned> tmpCount;
+};
+
+//===============================================================================================
+
+#endif
@@ -0,0 +1,819 @@
+//===============================================================================================
+// disasm.cc -- This file contains the class implementation for turning bytes back into
+// instructions.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-022   Initial version
+//
+//===============================================================================================
+
+#include "disasm.hpp"
+#include "encoder.hpp"
+#include "in-file.hpp"
+
+#include <cstring>
+#include <ios>
+
+#include <elf.h>
+
+//-----------------------------------------------------------------------------------------------
+// The prefix bytes: the segment overrides (in register order, from R_ES), LOCK, REPNE and REP.
+//-----------------------------------------------------------------------------------------------
+static const uint8_t segPrefix[] = {0x26, 0x2e, 0x36, 0x3e, 0x64, 0x65};
+static const uint8_t PFX_LOCK = 0xf0;
+static const uint8_t PFX_REPNE = 0xf2;
+static const uint8_t PFX_REP = 0xf3;
+
+//-----------------------------------------------------------------------------------------------
+// The names of the registers, by register id, and of the prefixes that are written out.
+//-----------------------------------------------------------------------------------------------
+static const char *const regName[] = {
+    "al", "cl", "dl", "bl", "ah", "ch", "dh", "bh",
+    "ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+    "es", "cs", "ss", "ds", "fs", "gs",
+};
+
+static const char *PrefixName(uint8_t b)
+{
+    switch (b) {
+    case PFX_LOCK: return "lock";
+    case PFX_REPNE: return "repne";
+    case PFX_REP: return "rep";
+    }
+
+    for (size_t i = 0; i < sizeof(segPrefix); i ++) if (segPrefix[i] == b) return regName[R_ES + i];
+    return "?";
+}
+
+//-----------------------------------------------------------------------------------------------
+// The base and index registers of each 16-bit r/m encoding (r/m 6 is [BP] only with mod 01 or
+// 10; with mod 00 it is a direct address).
+//-----------------------------------------------------------------------------------------------
+static const uint8_t rmBase[] = {R_BX, R_BX, R_BP, R_BP, R_NONE, R_NONE, R_BP, R_BX};
+static const uint8_t rmIndex[] = {R_SI, R_DI, R_SI, R_DI, R_SI, R_DI, R_NONE, R_NONE};
+
+//-----------------------------------------------------------------------------------------------
+// FixedRegister() returns the register a REG_xx operand type names, or R_NONE.
+//-----------------------------------------------------------------------------------------------
+static uint8_t FixedRegister(uint8_t t)
+{
+    switch (t) {
+    case REG_AL: return R_AL;
+    case REG_CL: return R_CL;
+    case REG_AX: return R_AX;
+    case REG_CX: return R_CX;
+    case REG_DX: return R_DX;
+    case REG_BX: return R_BX;
+    case REG_SP: return R_SP;
+    case REG_BP: return R_BP;
+    case REG_SI: return R_SI;
+    case REG_DI: return R_DI;
+    case REG_ES: return R_ES;
+    case REG_CS: return R_CS;
+    case REG_SS: return R_SS;
+    case REG_DS: return R_DS;
+    case REG_FS: return R_FS;
+    case REG_GS: return R_GS;
+    default: return R_NONE;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Decodable() is true for a row whose operand types are all ones the Encoder can write -- so
+// the ones that can come back.
+//-----------------------------------------------------------------------------------------------
+static bool Decodable(const OpCodeEntry *row)
+{
+    if (row->opcodeBytes < 1 || row->opcodeBytes > 2) return false;
+
+    for (int i = 0; i < 3; i ++) {
+        switch (row->type[i]) {
+        case OP_NONE: case REL8: case REL16: case PTR16_16: case R8: case R16: case IMM8:
+        case IMM16: case RM8: case RM16: case M: case M8: case M16: case M16_16: case MOFFS8:
+        case MOFFS16: case SREG: case ONE:
+            break;
+
+        default:
+            if (FixedRegister(row->type[i]) == R_NONE) return false;
+            break;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// RmIndex() and RegIndex() return which operand of a row is encoded in the ModR/M r/m field and
+// which is a register in the reg field (or added to the opcode); -1 if none.
+//-----------------------------------------------------------------------------------------------
+static int RmIndex(const OpCodeEntry *row)
+{
+    for (int i = 0; i < 3; i ++) {
+        switch (row->type[i]) {
+        case RM8: case RM16: case M: case M8: case M16: case M16_16: return i;
+        default: break;
+        }
+    }
+
+    return -1;
+}
+
+static int RegIndex(const OpCodeEntry *row)
+{
+    for (int i = 0; i < 3; i ++) {
+        if (row->type[i] == R8 || row->type[i] == R16 || row->type[i] == SREG) return i;
+    }
+
+    return -1;
+}
+
+//-----------------------------------------------------------------------------------------------
+// SignExtended() is true for the rows whose IMM8 is sign-extended to a word.
+//-----------------------------------------------------------------------------------------------
+static inline bool SignExtended(const OpCodeEntry *row)
+{
+    return row->byteCode[0] == 0x83 || row->byteCode[0] == 0x6a || row->byteCode[0] == 0x6b;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Get16() reads a little-endian word.
+//-----------------------------------------------------------------------------------------------
+static inline uint16_t Get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::Disassembler(uint32_t) builds the reverse index over the rows available to isa.
+//-----------------------------------------------------------------------------------------------
+Disassembler::Disassembler(uint32_t i) : isa(i)
+{
+    std::vector<const OpCodeEntry *> second[256];
+
+    memset(dispatch, 0, sizeof(dispatch));
+
+    for (size_t p = 0; p < 4; p ++) dispatch[segPrefix[p]].prefix = 1;
+    if (!(_386 & ~isa & ISA_CPU_MASK)) {
+        dispatch[segPrefix[4]].prefix = dispatch[segPrefix[5]].prefix = 1;
+    }
+    dispatch[PFX_LOCK].prefix = dispatch[PFX_REPNE].prefix = dispatch[PFX_REP].prefix = 1;
+
+    // -- where rows share an encoding, the first one in the table is kept
+    for (size_t r = 0; r < OpCodeCount; r ++) {
+        const OpCodeEntry *row = &OpCodeTable[r];
+        uint8_t b = row->byteCode[0];
+        Dispatch &d = dispatch[b];
+
+        if (!OpCodeAvailable(row->flags, isa) || !Decodable(row)) continue;
+
+        if (row->opcodeBytes == 2) {
+            second[b].push_back(row);
+        } else if (row->modRM_Part) {
+            if (!d.group) {
+                d.group = (uint16_t)(groups.size() + 1);
+                groups.resize(groups.size() + 8, NULL);
+            }
+
+            if (!groups[d.group - 1 + row->modRM_Op]) groups[d.group - 1 + row->modRM_Op] = row;
+        } else if (RmIndex(row) < 0 && RegIndex(row) >= 0) {
+            for (int k = 0; k < 8 && b + k < 256; k ++) {
+                if (!dispatch[b + k].row) dispatch[b + k].row = row;
+            }
+        } else if (!d.row) {
+            d.row = row;
+        }
+    }
+
+    for (int b = 0; b < 256; b ++) {
+        dispatch[b].twoFirst = (uint16_t)twos.size();
+        dispatch[b].twoCount = (uint8_t)second[b].size();
+        twos.insert(twos.end(), second[b].begin(), second[b].end());
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::DecodeRow(...) decodes the operands of row, whose opcode (opLen bytes) is at p,
+// at address.  It returns the length from p, or 0 if the bytes are not a valid instruction of
+// that row (they run out, or a register is where the row needs memory).
+//-----------------------------------------------------------------------------------------------
+size_t Disassembler::DecodeRow(const OpCodeEntry *row, const uint8_t *p, const uint8_t *end,
+        size_t opLen, uint32_t address, Instruction &ins) const
+{
+    const uint8_t *q = p + opLen;
+    Operand *ops = ins.ops;
+    int rm = RmIndex(row);
+    int reg = RegIndex(row);
+    uint8_t code = 0;
+    uint8_t maxSeg = (dispatch[segPrefix[4]].prefix ? R_GS : R_DS);
+
+    for (int i = 0; i < 3; i ++) ops[i] = Operand();
+
+    if (rm >= 0) {
+        if (q >= end) return 0;
+
+        uint8_t modrm = *q ++;
+        uint8_t mod = modrm >> 6;
+        uint8_t t = row->type[rm];
+        Operand &m = ops[rm];
+
+        code = (modrm >> 3) & 0x07;
+        if (row->modRM_Part && code != row->modRM_Op) return 0;
+
+        if (mod == 3) {
+            if (t != RM8 && t != RM16) return 0;
+
+            m.reg = (t == RM8 ? R_AL : R_AX) + (modrm & 0x07);
+            m.cls = OC_AL + m.reg;
+        } else {
+            bool direct = (mod == 0 && (modrm & 0x07) == 6);
+
+            if (direct) {
+                if (end - q < 2) return 0;
+                m.value = Get16(q);
+                q += 2;
+            } else {
+                m.base = rmBase[modrm & 0x07];
+                m.index = rmIndex[modrm & 0x07];
+
+                if (mod == 1) {
+                    if (q >= end) return 0;
+                    m.value = (int8_t)*q ++;
+                } else if (mod == 2) {
+                    if (end - q < 2) return 0;
+                    m.value = (int16_t)Get16(q);
+                    q += 2;
+                }
+            }
+
+            switch (t) {
+            case RM8: case M8: m.cls = (direct ? OC_MOFFS8 : OC_MEM8); break;
+            case RM16: case M16: m.cls = (direct ? OC_MOFFS16 : OC_MEM16); break;
+            case M16_16: m.cls = OC_MEM32; break;
+            default: m.cls = (direct ? OC_MOFFS : OC_MEM); break;
+            }
+        }
+    } else if (reg >= 0) {
+        code = (uint8_t)(p[opLen - 1] - row->byteCode[opLen - 1]);
+    }
+
+    if (reg >= 0) {
+        Operand &r = ops[reg];
+
+        r.reg = code + (row->type[reg] == R8 ? R_AL : row->type[reg] == R16 ? R_AX : R_ES);
+        if (r.reg > maxSeg) return 0;
+        r.cls = OC_AL + r.reg;
+    }
+
+    for (int i = 0; i < 3; i ++) {
+        Operand &op = ops[i];
+        uint8_t t = row->type[i];
+
+        switch (t) {
+        case IMM8:
+            if (q >= end) return 0;
+            op.value = (SignExtended(row) ? (int64_t)(int8_t)*q : (int64_t)*q);
+            op.cls = ImmediateClass(op.value);
+            q ++;
+            break;
+
+        case IMM16:
+            if (end - q < 2) return 0;
+            op.value = Get16(q);
+            op.cls = ImmediateClass(op.value);
+            q += 2;
+            break;
+
+        case MOFFS8:
+        case MOFFS16:
+            if (end - q < 2) return 0;
+            op.value = Get16(q);
+            op.cls = (t == MOFFS8 ? OC_MOFFS8 : OC_MOFFS16);
+            q += 2;
+            break;
+
+        case PTR16_16:
+            if (end - q < 4) return 0;
+            op.value = Get16(q);
+            op.segment = Get16(q + 2);
+            op.cls = OC_FAR;
+            q += 4;
+            break;
+
+        case REL8:
+            if (q >= end) return 0;
+            q ++;
+            op.value = (int64_t)address + (q - p) + (int8_t)q[-1];
+            op.cls = OC_IMM16;
+            break;
+
+        case REL16:
+            if (end - q < 2) return 0;
+            q += 2;
+            op.value = (int64_t)address + (q - p) + (int16_t)Get16(q - 2);
+            op.cls = OC_IMM16;
+            break;
+
+        case ONE:
+            op.value = 1;
+            op.cls = OC_ONE;
+            break;
+
+        default:
+            if (FixedRegister(t) != R_NONE) {
+                op.reg = FixedRegister(t);
+                op.cls = OC_AL + op.reg;
+            }
+            break;
+        }
+    }
+
+    ins.row = row;
+    return q - p;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::Decode(const uint8_t*, size_t, uint32_t, Instruction&) decodes one instruction.
+// The prefixes come first; a segment override is then given to the memory operand, if there is
+// one.  F3 90 is PAUSE rather than REP NOP when the ISA has it, so a prefix byte that starts a
+// 2-byte row is tried as that row first.
+//-----------------------------------------------------------------------------------------------
+size_t Disassembler::Decode(const uint8_t *p, size_t n, uint32_t address, Instruction &ins) const
+{
+    const uint8_t *q = p;
+    const uint8_t *end = p + n;
+    size_t len = 0;
+    int seg = -1;
+
+    ins.row = NULL;
+    ins.prefixCount = 0;
+    ins.length = 1;
+
+    auto two = [&](const uint8_t *at, uint32_t addr) -> size_t {
+        const Dispatch &d = dispatch[*at];
+
+        if (at + 1 >= end) return 0;
+
+        for (size_t i = d.twoFirst; i < (size_t)d.twoFirst + d.twoCount; i ++) {
+            if (twos[i]->byteCode[1] != at[1]) continue;
+
+            size_t l = DecodeRow(twos[i], at, end, 2, addr, ins);
+            if (l) return l;
+        }
+
+        return 0;
+    };
+
+    while (q < end && dispatch[*q].prefix && ins.prefixCount < MAX_PREFIXES) {
+        if ((len = two(q, address + (q - p)))) break;
+
+        for (size_t i = 0; i < sizeof(segPrefix); i ++) {
+            if (*q == segPrefix[i]) seg = ins.prefixCount;
+        }
+        ins.prefix[ins.prefixCount ++] = *q ++;
+    }
+
+    if (!len && q < end) {
+        const Dispatch &d = dispatch[*q];
+        uint32_t at = address + (q - p);
+
+        len = two(q, at);
+
+        if (!len && d.group && q + 1 < end) {
+            const OpCodeEntry *row = groups[d.group - 1 + ((q[1] >> 3) & 0x07)];
+            if (row) len = DecodeRow(row, q, end, 1, at, ins);
+        }
+
+        if (!len && d.row) len = DecodeRow(d.row, q, end, 1, at, ins);
+    }
+
+    if (!len) {
+        ins.row = NULL;
+        ins.prefixCount = 0;
+        return 1;
+    }
+
+    // -- the (last) segment override belongs to the memory operand, if there is one
+    for (int i = 0; seg >= 0 && i < 3; i ++) {
+        if (!ins.ops[i].IsMemory()) continue;
+
+        for (size_t s = 0; s < sizeof(segPrefix); s ++) {
+            if (segPrefix[s] == ins.prefix[seg]) ins.ops[i].seg = (uint8_t)(R_ES + s);
+        }
+
+        memmove(ins.prefix + seg, ins.prefix + seg + 1, ins.prefixCount - seg - 1);
+        ins.prefixCount --;
+        break;
+    }
+
+    ins.length = (uint8_t)(q - p + len);
+    return ins.length;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Hex() writes v in hex, with at least width digits, and returns the end.
+//-----------------------------------------------------------------------------------------------
+static char *Hex(char *o, uint64_t v, int width)
+{
+    static const char digits[] = "0123456789abcdef";
+    char buf[16];
+    int n = 0;
+
+    do {
+        buf[n ++] = digits[v & 0x0f];
+        v >>= 4;
+    } while (v);
+
+    while (n < width) buf[n ++] = '0';
+    while (n) *o ++ = buf[-- n];
+
+    return o;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Number() writes a value as a 0x hex number, with a minus sign if it is negative.
+//-----------------------------------------------------------------------------------------------
+static char *Number(char *o, int64_t v)
+{
+    if (v < 0) {
+        *o ++ = '-';
+        v = -v;
+    }
+
+    *o ++ = '0';
+    *o ++ = 'x';
+    return Hex(o, (uint64_t)v, 1);
+}
+
+static inline char *Put(char *o, const char *s)
+{
+    while (*s) *o ++ = *s ++;
+    return o;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::Format(...) writes the listing line for ins: its address, its bytes, and the
+// instruction as the assembler would read it.
+//-----------------------------------------------------------------------------------------------
+char *Disassembler::Format(const Instruction &ins, const uint8_t *bytes, uint32_t address,
+        char *o) const
+{
+    static const size_t BYTE_COLUMNS = 7;
+    uint32_t mask = (address <= 0xffff ? 0xffff : 0xffffffff);
+
+    o = Hex(o, address, (address <= 0xffff ? 4 : 8));
+    *o ++ = ':';
+    *o ++ = ' ';
+
+    for (size_t i = 0; i < BYTE_COLUMNS || i < ins.length; i ++) {
+        *o ++ = ' ';
+        if (i < ins.length) {
+            o = Hex(o, bytes[i], 2);
+        } else {
+            *o ++ = ' ';
+            *o ++ = ' ';
+        }
+    }
+
+    *o ++ = ' ';
+    *o ++ = ' ';
+
+    if (!ins.row) {
+        o = Put(o, "(bad)");
+        *o ++ = '\n';
+        return o;
+    }
+
+    char *start = o;
+
+    for (size_t i = 0; i < ins.prefixCount; i ++) {
+        o = Put(o, PrefixName(ins.prefix[i]));
+        *o ++ = ' ';
+    }
+
+    const char *name = ins.row->mnemonic->name;
+    for (size_t i = 0; i < sizeof(ins.row->mnemonic->name) && name[i]; i ++) {
+        *o ++ = (char)(name[i] | 0x20);
+    }
+
+    if (ins.row->type[0] != OP_NONE) {
+        do *o ++ = ' '; while (o - start < 8);
+    }
+
+    for (int i = 0; i < 3 && ins.row->type[i] != OP_NONE; i ++) {
+        const Operand &op = ins.ops[i];
+        uint8_t t = ins.row->type[i];
+
+        if (i) *o ++ = ',', *o ++ = ' ';
+
+        if (op.reg != R_NONE) {
+            o = Put(o, regName[op.reg]);
+        } else if (op.IsMemory()) {
+            switch (op.cls) {
+            case OC_MEM8: case OC_MOFFS8: o = Put(o, "byte ptr "); break;
+            case OC_MEM16: case OC_MOFFS16: o = Put(o, "word ptr "); break;
+            case OC_MEM32: o = Put(o, "dword ptr "); break;
+            default: break;
+            }
+
+            if (op.seg != R_NONE) {
+                o = Put(o, regName[op.seg]);
+                *o ++ = ':';
+            }
+
+            *o ++ = '[';
+
+            if (op.base == R_NONE && op.index == R_NONE) {
+                o = Number(o, op.value);
+            } else {
+                if (op.base != R_NONE) o = Put(o, regName[op.base]);
+                if (op.base != R_NONE && op.index != R_NONE) *o ++ = '+';
+                if (op.index != R_NONE) o = Put(o, regName[op.index]);
+                if (op.value > 0) *o ++ = '+';
+                if (op.value) o = Number(o, op.value);
+            }
+
+            *o ++ = ']';
+        } else if (t == PTR16_16) {
+            o = Number(o, op.segment);
+            *o ++ = ':';
+            o = Number(o, op.value);
+        } else if (t == REL8 || t == REL16) {
+            o = Number(o, op.value & mask);
+        } else if (t == ONE) {
+            *o ++ = '1';
+        } else {
+            o = Number(o, op.value);
+        }
+    }
+
+    *o ++ = '\n';
+    return o;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::List(const uint8_t*, size_t, uint32_t, std::string&) appends the listing of n
+// bytes of code at address to out.  The lines are built in a local buffer and appended in
+// blocks, as a listing can be millions of lines.
+//-----------------------------------------------------------------------------------------------
+void Disassembler::List(const uint8_t *p, size_t n, uint32_t address, std::string &out) const
+{
+    static const size_t LINE_MAX = 160;
+    char buf[64 * LINE_MAX];
+    char *o = buf;
+    Instruction ins;
+
+    out.reserve(out.size() + n * 20);
+
+    for (size_t off = 0; off < n; off += ins.length) {
+        Decode(p + off, n - off, address + (uint32_t)off, ins);
+        o = Format(ins, p + off, address + (uint32_t)off, o);
+
+        if (o - buf > (ptrdiff_t)(sizeof(buf) - LINE_MAX)) {
+            out.append(buf, o - buf);
+            o = buf;
+        }
+    }
+
+    out.append(buf, o - buf);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Elf32 and Elf64 are the differences between the 2 classes of object; ListElf() lists the code
+// sections of either.
+//-----------------------------------------------------------------------------------------------
+struct Elf32 {
+    typedef Elf32_Ehdr Ehdr;
+    typedef Elf32_Shdr Shdr;
+};
+
+struct Elf64 {
+    typedef Elf64_Ehdr Ehdr;
+    typedef Elf64_Shdr Shdr;
+};
+
+template <class E>
+static void ListElf(const Disassembler &dis, const std::string &name, const uint8_t *data,
+        size_t size, std::string &out)
+{
+    typedef typename E::Ehdr Ehdr;
+    typedef typename E::Shdr Shdr;
+    const Ehdr *eh = reinterpret_cast<const Ehdr *>(data);
+
+    auto bad = [&name]() { return std::ios_base::failure("Invalid ELF file " + name); };
+
+    if (size < sizeof(Ehdr) || eh->e_shentsize != sizeof(Shdr) || eh->e_shoff > size
+            || (size - eh->e_shoff) / sizeof(Shdr) < eh->e_shnum || eh->e_shstrndx >= eh->e_shnum) {
+        throw bad();
+    }
+
+    const Shdr *sh = reinterpret_cast<const Shdr *>(data + eh->e_shoff);
+    const Shdr &str = sh[eh->e_shstrndx];
+
+    if (str.sh_offset > size || str.sh_size > size - str.sh_offset) throw bad();
+
+    for (size_t i = 0; i < eh->e_shnum; i ++) {
+        if (sh[i].sh_type != SHT_PROGBITS || !(sh[i].sh_flags & SHF_EXECINSTR)) continue;
+        if (sh[i].sh_offset > size || sh[i].sh_size > size - sh[i].sh_offset) throw bad();
+
+        const char *s = "";
+
+        if (sh[i].sh_name < str.sh_size) s = (const char *)data + str.sh_offset + sh[i].sh_name;
+
+        out += "\nsection ";
+        out.append(s, strnlen(s, str.sh_size - sh[i].sh_name));
+        out += ":\n";
+        dis.List(data + sh[i].sh_offset, sh[i].sh_size, (uint32_t)sh[i].sh_addr, out);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::ListFile(const std::string&, uint32_t, std::string&) appends the listing of a
+// file: each code section of an ELF object, or else all of it as a flat binary loaded at base.
+//-----------------------------------------------------------------------------------------------
+void Disassembler::ListFile(const std::string &name, uint32_t base, std::string &out) const
+{
+    std::shared_ptr<const MappedFile> f = MappedFile::Open(name);
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(f->Data());
+    size_t size = f->Size();
+
+    if (size >= EI_NIDENT && memcmp(data, ELFMAG, SELFMAG) == 0) {
+        if (data[EI_CLASS] == ELFCLASS32) ListElf<Elf32>(*this, name, data, size, out);
+        else if (data[EI_CLASS] == ELFCLASS64) ListElf<Elf64>(*this, name, data, size, out);
+        else throw std::ios_base::failure("Invalid ELF file " + name);
+
+        return;
+    }
+
+    List(data, size, base, out);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Choices() fills in the operands Check() tries for an operand type: every register, every
+// addressing form with no, a byte and a word displacement (and with an override), and
+// immediates and targets at the edges of their ranges.
+//-----------------------------------------------------------------------------------------------
+static void Choices(uint8_t t, uint32_t address, uint8_t maxSeg, std::vector<Operand> &out)
+{
+    static const int64_t disps[] = {0, 5, -0x50, 0x1234};
+    Operand op;
+
+    out.clear();
+
+    auto memory = [&](uint8_t cls, uint8_t moffs) {
+        size_t first = out.size();
+
+        for (int rm = 0; rm < 8; rm ++) {
+            for (size_t d = 0; d < sizeof(disps) / sizeof(disps[0]); d ++) {
+                op = Operand();
+                op.cls = cls;
+                op.base = rmBase[rm];
+                op.index = rmIndex[rm];
+                op.value = disps[d];
+                out.push_back(op);
+            }
+        }
+
+        op = Operand();
+        op.cls = moffs;
+        op.value = 0x1234;
+        out.push_back(op);
+
+        op.seg = R_ES;
+        out.push_back(op);
+
+        op = out[first + 1];                    // [bx+si+5]
+        op.seg = R_CS;
+        out.push_back(op);
+    };
+
+    auto regs = [&](uint8_t first, uint8_t last) {
+        for (uint8_t r = first; r <= last; r ++) {
+            op = Operand();
+            op.reg = r;
+            op.cls = OC_AL + r;
+            out.push_back(op);
+        }
+    };
+
+    auto values = [&](std::initializer_list<int64_t> vs, bool immediate) {
+        for (int64_t v : vs) {
+            op = Operand();
+            op.value = v;
+            op.cls = (immediate ? ImmediateClass(v) : (uint8_t)OC_IMM16);
+            out.push_back(op);
+        }
+    };
+
+    switch (t) {
+    case R8: regs(R_AL, R_BH); break;
+    case R16: regs(R_AX, R_DI); break;
+    case SREG: regs(R_ES, maxSeg); break;
+    case RM8: regs(R_AL, R_BH); memory(OC_MEM8, OC_MOFFS8); break;
+    case RM16: regs(R_AX, R_DI); memory(OC_MEM16, OC_MOFFS16); break;
+    case M: memory(OC_MEM, OC_MOFFS); break;
+    case M8: memory(OC_MEM8, OC_MOFFS8); break;
+    case M16: memory(OC_MEM16, OC_MOFFS16); break;
+    case M16_16: memory(OC_MEM32, OC_MEM32); break;
+    case IMM8: values({0, 0x7f, 0x80, 0xff}, true); break;
+    case IMM16: values({0, 0x1234, 0xffff}, true); break;
+    case REL8: values({address - 0x60, address, address + 0x60}, false); break;
+    case REL16: values({0x10, address, address + 0x3000}, false); break;
+
+    case MOFFS8:
+    case MOFFS16:
+        op.cls = (t == MOFFS8 ? OC_MOFFS8 : OC_MOFFS16);
+        op.value = 0x1234;
+        out.push_back(op);
+        op.seg = R_ES;
+        out.push_back(op);
+        break;
+
+    case PTR16_16:
+        op.cls = OC_FAR;
+        op.value = 0x1234;
+        op.segment = 0x5678;
+        out.push_back(op);
+        break;
+
+    case ONE:
+        op.cls = OC_ONE;
+        op.value = 1;
+        out.push_back(op);
+        break;
+
+    default:
+        if ((op.reg = FixedRegister(t)) != R_NONE) op.cls = OC_AL + op.reg;
+        out.push_back(op);
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Disassembler::Check(std::ostream&, size_t&) is the round trip: every row available to the ISA
+// is encoded with every combination of the Choices() for its operands, and each encoding must
+// decode to an instruction of the same length that encodes to the same bytes.  (It need not be
+// the same row: JZ comes back as JE.)
+//-----------------------------------------------------------------------------------------------
+size_t Disassembler::Check(std::ostream &report, size_t &checked) const
+{
+    static const uint32_t ADDRESS = 0x1000;
+    uint8_t maxSeg = (dispatch[segPrefix[4]].prefix ? R_GS : R_DS);
+    std::vector<Operand> choices[3];
+    uint8_t bytes[Encoder::MAX_LENGTH];
+    uint8_t again[Encoder::MAX_LENGTH];
+    size_t failures = 0;
+    Instruction ins;
+    Operand ops[3];
+
+    checked = 0;
+
+    for (size_t r = 0; r < OpCodeCount; r ++) {
+        const OpCodeEntry *row = &OpCodeTable[r];
+
+        if (!OpCodeAvailable(row->flags, isa) || !Decodable(row)) continue;
+
+        for (int i = 0; i < 3; i ++) Choices(row->type[i], ADDRESS, maxSeg, choices[i]);
+
+        for (size_t a = 0; a < choices[0].size(); a ++) {
+            for (size_t b = 0; b < choices[1].size(); b ++) {
+                for (size_t c = 0; c < choices[2].size(); c ++) {
+                    ops[0] = choices[0][a];
+                    ops[1] = choices[1][b];
+                    ops[2] = choices[2][c];
+
+                    size_t n = Encoder::Encode(row, ops, ADDRESS, bytes);
+                    if (!n) continue;
+
+                    checked ++;
+                    Decode(bytes, n, ADDRESS, ins);
+
+                    if (ins.row && ins.length == n && ins.prefixCount == 0
+                            && Encoder::Encode(ins.row, ins.ops, ADDRESS, again) == n
+                            && memcmp(bytes, again, n) == 0) {
+                        continue;
+                    }
+
+                    char line[160];
+                    char hex[3 * Encoder::MAX_LENGTH];
+                    char *e = Format(ins, bytes, ADDRESS, line);
+                    char *h = hex;
+
+                    for (size_t k = 0; k < n; k ++) {
+                        if (k) *h ++ = ' ';
+                        h = Hex(h, bytes[k], 2);
+                    }
+
+                    failures ++;
+                    report << "as-cent: round trip: row " << r << " (" << row->mnemonic->name
+                            << ") encodes as " << std::string(hex, h - hex) << ", which decodes as "
+                            << std::string(line, e - line);
+                }
+            }
+        }
+    }
+
+    return failures;
+}
+
+//===============================================================================================
@@ -0,0 +1,103 @@
+//===============================================================================================
+// disasm.hpp -- This file contains the class definition for turning bytes back into instructions.
+//
+// The disassembler reads the same OpCodeTable the assembler does, through a reverse index built
+// once for an ISA:
+//
+// * A 256-entry dispatch array on the first opcode byte.  Most bytes are decided by that alone:
+//   the entry is the row.  A row that adds a register to its opcode (`+r`) fills the 8 bytes
+//   from its opcode up.
+// * For the rows with an opcode extension (modRM_Part Y, `/digit`), the entry is a group of 8
+//   rows instead, picked by the reg field of the ModR/M byte that follows.  That covers the
+//   80/81/83 arithmetic groups, the shifts, F6/F7, FE/FF and the like.
+// * The few rows with a second opcode byte (AAD and AAM with their default base, PAUSE, and the
+//   0F rows) are a short list on their first byte, tried before the one-byte meaning.
+// * Segment overrides, LOCK and the REP prefixes are marked as such and are collected before the
+//   opcode.
+//
+// Where rows share an encoding (JE and JZ, SAL and SHL) the first in the table is the one shown.
+// A byte that does not start an instruction the ISA has is listed on its own as `(bad)`.
+//
+// Decode() fills in the row and the same Operands the Parser would produce, so that the result
+// can be handed straight back to the Encoder.  Check() uses that for the round trip: it encodes
+// every row in the ISA with a spread of operands, decodes the bytes, and checks that they decode
+// to the same length and re-encode to the same bytes.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-022   Initial version
+//
+//===============================================================================================
+
+#ifndef __DISASM_HPP__
+#define __DISASM_HPP__
+
+#ifndef __cplusplus
+#error The file 'disasm.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "OpCodeTable.h"
+#include "operand.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The Disassembler class holds the reverse index for one ISA; once built it is only read, so
+// one Disassembler may be used from many threads.
+//
+// Decode() decodes the instruction at p (with n bytes available) at address and returns its
+// length, which is always at least 1 when n is: a byte that cannot be decoded is returned as an
+// Instruction with no row.  List() appends one line per instruction for a block of code, and
+// ListFile() does that for a flat binary loaded at base or for each code section of an ELF
+// object.  Check() returns the number of round trips that failed, reporting each to report,
+// and sets checked to the number tried.
+//-----------------------------------------------------------------------------------------------
+class Disassembler {
+public:
+    static const size_t MAX_PREFIXES = 4;
+
+    struct Instruction {
+        const OpCodeEntry *row;             // NULL for a byte that does not start an instruction
+        Operand ops[3];
+        uint8_t prefix[MAX_PREFIXES];       // LOCK, REP, or a segment override left unused
+        uint8_t prefixCount;
+        uint8_t length;
+    };
+
+public:
+    Disassembler(uint32_t isa = ISA_DEFAULT);
+
+public:
+    size_t Decode(const uint8_t *p, size_t n, uint32_t address, Instruction &ins) const;
+    void List(const uint8_t *p, size_t n, uint32_t address, std::string &out) const;
+    void ListFile(const std::string &name, uint32_t base, std::string &out) const;
+    size_t Check(std::ostream &report, size_t &checked) const;
+
+private:
+    struct Dispatch {
+        const OpCodeEntry *row;             // the row the byte alone decides; else NULL
+        uint16_t group;                     // 1 + the first of 8 rows in groups, by reg; or 0
+        uint16_t twoFirst;                  // the rows in twos with a second opcode byte
+        uint8_t twoCount;
+        uint8_t prefix;                     // the byte is a prefix
+    };
+
+private:
+    size_t DecodeRow(const OpCodeEntry *row, const uint8_t *p, const uint8_t *end, size_t opLen,
+            uint32_t address, Instruction &ins) const;
+    char *Format(const Instruction &ins, const uint8_t *bytes, uint32_t address, char *out) const;
+
+private:
+    uint32_t isa;
+    Dispatch dispatch[256];
+    std::vector<const OpCodeEntry *> groups;
+    std::vector<const OpCodeEntry *> twos;
+};
+
+//===============================================================================================
+
+#endif
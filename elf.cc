@@ -0,0 +1,247 @@
+//===============================================================================================
+// elf.cc -- This file contains the class implementation for writing an ELF relocatable object.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-014   Initial version
+// 2026-10-16  ADCL   U-015   The mapped output file is now an OutputFile
+// 2026-10-16  ADCL   U-016   Added the external symbols and their relocations
+// 2026-10-16  ADCL   U-014   Commit() the OutputFile once it is written
+//
+//===============================================================================================
+
+#include "elf.hpp"
+#include "out-file.hpp"
+
+#include <cstring>
+#include <unordered_map>
+
+#include <elf.h>
+
+//-----------------------------------------------------------------------------------------------
+// The section indexes, and the symbol index of the .text section symbol.
+//-----------------------------------------------------------------------------------------------
+enum {SH_NULL, SH_TEXT, SH_REL, SH_SYMTAB, SH_STRTAB, SH_SHSTRTAB, SH_COUNT};
+static const uint32_t SYM_TEXT = 2;
+static const uint32_t SYM_FIRST_LABEL = 3;
+
+//-----------------------------------------------------------------------------------------------
+// Elf32 and Elf64 are the differences between the 2 classes of object; everything else is
+// written by the same template.  ELF32 objects use REL (the addend is in the field), ELF64
+// objects RELA.
+//-----------------------------------------------------------------------------------------------
+struct Elf32 {
+    typedef Elf32_Ehdr Ehdr;
+    typedef Elf32_Shdr Shdr;
+    typedef Elf32_Sym Sym;
+    typedef Elf32_Rel Rel;
+
+    static const unsigned char CLASS = ELFCLASS32;
+    static const uint16_t MACHINE = EM_386;
+    static const uint32_t REL_TYPE = SHT_REL;
+    static const uint32_t R_16 = R_386_16;
+    static const uint32_t R_8 = R_386_8;
+    static const uint32_t R_PC16 = R_386_PC16;
+    static const uint32_t R_PC8 = R_386_PC8;
+    static const size_t ALIGN = 4;
+
+    static const char *RelName(void) { return ".rel.text"; };
+    static void SetRel(Rel &r, const Reloc &rel, uint32_t sym, uint32_t type) {
+        r.r_offset = rel.offset;
+        r.r_info = ELF32_R_INFO(sym, type);
+    };
+};
+
+struct Elf64 {
+    typedef Elf64_Ehdr Ehdr;
+    typedef Elf64_Shdr Shdr;
+    typedef Elf64_Sym Sym;
+    typedef Elf64_Rela Rel;
+
+    static const unsigned char CLASS = ELFCLASS64;
+    static const uint16_t MACHINE = EM_X86_64;
+    static const uint32_t REL_TYPE = SHT_RELA;
+    static const uint32_t R_16 = R_X86_64_16;
+    static const uint32_t R_8 = R_X86_64_8;
+    static const uint32_t R_PC16 = R_X86_64_PC16;
+    static const uint32_t R_PC8 = R_X86_64_PC8;
+    static const size_t ALIGN = 8;
+
+    static const char *RelName(void) { return ".rela.text"; };
+    static void SetRel(Rel &r, const Reloc &rel, uint32_t sym, uint32_t type) {
+        r.r_offset = rel.offset;
+        r.r_info = ELF64_R_INFO(sym, type);
+        r.r_addend = rel.addend;
+    };
+};
+
+//-----------------------------------------------------------------------------------------------
+// Align() rounds an offset up to a power of 2.
+//-----------------------------------------------------------------------------------------------
+static inline size_t Align(size_t off, size_t align)
+{
+    return (off + align - 1) & ~(align - 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// WriteElf() lays out and writes an object of class E.
+//-----------------------------------------------------------------------------------------------
+template <typename E>
+static void WriteElf(const std::string &path, const std::string &source, const Section &text,
+        const std::vector<Symbol *> &labels, const std::vector<Reloc> &relocs,
+        const SymbolTable &symTab)
+{
+    typedef typename E::Ehdr Ehdr;
+    typedef typename E::Shdr Shdr;
+    typedef typename E::Sym Sym;
+    typedef typename E::Rel Rel;
+
+    // -- the section names, as they are laid out in .shstrtab
+    std::string shstr = std::string("\0.text\0", 7) + E::RelName()
+            + std::string("\0.symtab\0.strtab\0.shstrtab\0", 27);
+    uint32_t shName[SH_COUNT] = {0, 1, 7, 0, 0, 0};
+    shName[SH_SYMTAB] = (uint32_t)shstr.find(".symtab");
+    shName[SH_STRTAB] = (uint32_t)shstr.find(".strtab");
+    shName[SH_SHSTRTAB] = (uint32_t)shstr.find(".shstrtab");
+
+    // -- the externals are numbered after the labels, in the order they are first referenced
+    std::vector<const Symbol *> externs;
+    std::unordered_map<const Symbol *, uint32_t> externIndex;
+    size_t localCount = SYM_FIRST_LABEL + labels.size();
+
+    for (size_t i = 0; i < relocs.size(); i ++) {
+        const Symbol *x = relocs[i].sym;
+
+        if (x && externIndex.emplace(x, (uint32_t)(localCount + externs.size())).second) {
+            externs.push_back(x);
+        }
+    }
+
+    // -- the layout
+    size_t symCount = localCount + externs.size();
+    size_t strSize = 1 + source.size() + 1;
+
+    for (size_t i = 0; i < labels.size(); i ++) strSize += symTab.Name(labels[i]).size() + 1;
+    for (size_t i = 0; i < externs.size(); i ++) strSize += symTab.Name(externs[i]).size() + 1;
+
+    size_t textOff = Align(sizeof(Ehdr), 16);
+    size_t relOff = Align(textOff + text.Size(), E::ALIGN);
+    size_t symOff = Align(relOff + relocs.size() * sizeof(Rel), E::ALIGN);
+    size_t strOff = symOff + symCount * sizeof(Sym);
+    size_t shstrOff = strOff + strSize;
+    size_t shOff = Align(shstrOff + shstr.size(), E::ALIGN);
+    size_t total = shOff + SH_COUNT * sizeof(Shdr);
+
+    OutputFile out(path, total);
+
+    // -- the ELF header
+    Ehdr *eh = out.At<Ehdr>(0);
+    memcpy(eh->e_ident, ELFMAG, SELFMAG);
+    eh->e_ident[EI_CLASS] = E::CLASS;
+    eh->e_ident[EI_DATA] = ELFDATA2LSB;
+    eh->e_ident[EI_VERSION] = EV_CURRENT;
+    eh->e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    eh->e_type = ET_REL;
+    eh->e_machine = E::MACHINE;
+    eh->e_version = EV_CURRENT;
+    eh->e_shoff = shOff;
+    eh->e_ehsize = sizeof(Ehdr);
+    eh->e_shentsize = sizeof(Shdr);
+    eh->e_shnum = SH_COUNT;
+    eh->e_shstrndx = SH_SHSTRTAB;
+
+    // -- the code and its relocations
+    if (text.Size()) memcpy(out.At<uint8_t>(textOff), text.Data(), text.Size());
+
+    Rel *rel = out.At<Rel>(relOff);
+
+    for (size_t i = 0; i < relocs.size(); i ++) {
+        const Reloc &r = relocs[i];
+        uint32_t type = (r.relative ? (r.size == 1 ? E::R_PC8 : E::R_PC16)
+                : (r.size == 1 ? E::R_8 : E::R_16));
+
+        E::SetRel(rel[i], r, (r.sym ? externIndex[r.sym] : SYM_TEXT), type);
+    }
+
+    // -- the symbols and their names, together
+    Sym *sym = out.At<Sym>(symOff);
+    char *str = out.At<char>(strOff);
+    uint32_t strAt = 1;
+
+    memcpy(str + strAt, source.data(), source.size());
+    sym[1].st_name = strAt;
+    sym[1].st_info = ELF32_ST_INFO(STB_LOCAL, STT_FILE);
+    sym[1].st_shndx = SHN_ABS;
+    strAt += source.size() + 1;
+
+    sym[SYM_TEXT].st_info = ELF32_ST_INFO(STB_LOCAL, STT_SECTION);
+    sym[SYM_TEXT].st_shndx = SH_TEXT;
+
+    for (size_t i = 0; i < labels.size(); i ++) {
+        std::string_view name = symTab.Name(labels[i]);
+        Sym &s = sym[SYM_FIRST_LABEL + i];
+
+        memcpy(str + strAt, name.data(), name.size());
+        s.st_name = strAt;
+        s.st_value = labels[i]->Value();
+        s.st_info = ELF32_ST_INFO(STB_LOCAL, STT_NOTYPE);
+        s.st_shndx = SH_TEXT;
+        strAt += name.size() + 1;
+    }
+
+    for (size_t i = 0; i < externs.size(); i ++) {
+        std::string_view name = symTab.Name(externs[i]);
+        Sym &s = sym[localCount + i];
+
+        memcpy(str + strAt, name.data(), name.size());
+        s.st_name = strAt;
+        s.st_info = ELF32_ST_INFO(STB_GLOBAL, STT_NOTYPE);
+        s.st_shndx = SHN_UNDEF;
+        strAt += name.size() + 1;
+    }
+
+    memcpy(out.At<char>(shstrOff), shstr.data(), shstr.size());
+
+    // -- the section headers
+    Shdr *sh = out.At<Shdr>(shOff);
+
+    auto section = [&](int i, uint32_t type, size_t off, size_t size, size_t align) -> Shdr & {
+        sh[i].sh_name = shName[i];
+        sh[i].sh_type = type;
+        sh[i].sh_offset = off;
+        sh[i].sh_size = size;
+        sh[i].sh_addralign = align;
+        return sh[i];
+    };
+
+    section(SH_TEXT, SHT_PROGBITS, textOff, text.Size(), 16).sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+
+    Shdr &r = section(SH_REL, E::REL_TYPE, relOff, relocs.size() * sizeof(Rel), E::ALIGN);
+    r.sh_flags = SHF_INFO_LINK;
+    r.sh_link = SH_SYMTAB;
+    r.sh_info = SH_TEXT;
+    r.sh_entsize = sizeof(Rel);
+
+    Shdr &s = section(SH_SYMTAB, SHT_SYMTAB, symOff, symCount * sizeof(Sym), E::ALIGN);
+    s.sh_link = SH_STRTAB;
+    s.sh_info = localCount;             // one past the last local symbol
+    s.sh_entsize = sizeof(Sym);
+
+    section(SH_STRTAB, SHT_STRTAB, strOff, strSize, 1);
+    section(SH_SHSTRTAB, SHT_STRTAB, shstrOff, shstr.size(), 1);
+
+    out.Commit();
+}
+
+//-----------------------------------------------------------------------------------------------
+// ElfWriter::Write(...) writes the object file for text to path.
+//-----------------------------------------------------------------------------------------------
+void ElfWriter::Write(const std::string &path, ElfClass cls, const std::string &source,
+        const Section &text, const std::vector<Symbol *> &labels, const std::vector<Reloc> &relocs,
+        const SymbolTable &symTab)
+{
+    if (cls == ELF64) WriteElf<Elf64>(path, source, text, labels, relocs, symTab);
+    else WriteElf<Elf32>(path, source, text, labels, relocs, symTab);
+}
+
+//===============================================================================================
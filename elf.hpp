@@ -0,0 +1,62 @@
+//===============================================================================================
+// elf.hpp -- This file contains the class definition for writing an ELF relocatable object.
+//
+// The object has a fixed set of sections:
+//
+// [0] the null section
+// [1] .text                -- the code
+// [2] .rel.text/.rela.text -- one R_386_16 (R_X86_64_16) for each address in the code, against
+//                             the section symbol for .text, and one R_386_16 or R_386_PC16 for
+//                             each reference to an external symbol
+// [3] .symtab              -- the null symbol, the file, the .text section, every label, then
+//                             the external symbols
+// [4] .strtab
+// [5] .shstrtab
+//
+// Since all of that is known before anything is written, the layout is worked out in a single
+// pass: the size (and so the offset) of every part is computed from the counts alone.  The
+// output file is then sized and mapped, and each part is written straight into place -- the
+// names are copied once, from the interned strings, into the string table in the mapping.
+//
+// Every label is a local symbol for now; there is no directive to make one global.  A symbol
+// that was never defined is an external (global and undefined) as it is with GNU as.  The
+// 16-bit relocations are the GNU extensions that ld understands for 16-bit code.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-014   Initial version
+// 2026-10-16  ADCL   U-016   Added the external symbols and their relocations
+//
+//===============================================================================================
+
+#ifndef __ELF_HPP__
+#define __ELF_HPP__
+
+#ifndef __cplusplus
+#error The file 'elf.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "relax.hpp"
+#include "section.hpp"
+#include "symtab.h"
+
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The ElfWriter class has no state.  Write() throws std::ios_base::failure if the file cannot be
+// created or mapped.
+//-----------------------------------------------------------------------------------------------
+class ElfWriter {
+public:
+    typedef enum {ELF32, ELF64} ElfClass;
+
+public:
+    static void Write(const std::string &path, ElfClass cls, const std::string &source,
+            const Section &text, const std::vector<Symbol *> &labels,
+            const std::vector<Reloc> &relocs, const SymbolTable &symTab);
+};
+
+//===============================================================================================
+
+#endif
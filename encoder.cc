@@ -0,0 +1,172 @@
+//===============================================================================================
+// encoder.cc -- This file contains the class implementation for turning an instruction into
+// bytes.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-012   Initial version
+// 2026-10-16  ADCL   U-013   Record the operand fields; a displacement to a label is 16 bits
+//
+//===============================================================================================
+
+#include "encoder.hpp"
+
+#include <cstring>
+
+//-----------------------------------------------------------------------------------------------
+// The segment override prefixes, indexed by segment register (from R_ES).
+//-----------------------------------------------------------------------------------------------
+static const uint8_t segPrefix[] = {0x26, 0x2e, 0x36, 0x3e, 0x64, 0x65};
+
+//-----------------------------------------------------------------------------------------------
+// Put16() writes a little-endian word.
+//-----------------------------------------------------------------------------------------------
+static inline uint8_t *Put16(uint8_t *p, int64_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+//-----------------------------------------------------------------------------------------------
+// RmCode() returns the r/m field for a 16-bit memory operand with a base and/or index register.
+//-----------------------------------------------------------------------------------------------
+static inline uint8_t RmCode(uint8_t base, uint8_t index)
+{
+    if (index == R_NONE) return (base == R_BP ? 6 : 7);
+    if (base == R_NONE) return (index == R_SI ? 4 : 5);
+    return (base == R_BP ? 2 : 0) + (index == R_DI ? 1 : 0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// ModRM() writes the ModR/M byte and any displacement for op, with reg in the reg field.  The
+// displacement is taken modulo 64K, as the processor does, and is as short as it can be.  [BP]
+// has no mod 00 form (that r/m is the direct address) so it always gets a displacement.  A
+// displacement to a label is always a word, since the Relaxer will patch it.
+//-----------------------------------------------------------------------------------------------
+static uint8_t *ModRM(uint8_t *p, uint8_t reg, const Operand &op)
+{
+    reg = (reg & 0x07) << 3;
+
+    if (!op.IsMemory()) {
+        *p ++ = 0xc0 | reg | RegCode(op.reg);
+        return p;
+    }
+
+    if (op.base == R_NONE && op.index == R_NONE) {
+        *p ++ = 0x06 | reg;
+        return Put16(p, op.value);
+    }
+
+    uint8_t rm = RmCode(op.base, op.index);
+    int16_t disp = (int16_t)op.value;
+
+    if (op.IsRelocatable()) {
+        *p ++ = 0x80 | rm | reg;
+        p = Put16(p, disp);
+    } else if (disp == 0 && rm != 6) {
+        *p ++ = rm | reg;
+    } else if (disp >= -128 && disp <= 127) {
+        *p ++ = 0x40 | rm | reg;
+        *p ++ = (uint8_t)disp;
+    } else {
+        *p ++ = 0x80 | rm | reg;
+        p = Put16(p, disp);
+    }
+
+    return p;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Encoder::Encode(const OpCodeEntry*, const Operand*, uint32_t, uint8_t*) encodes one
+// instruction at address into out.  ops has one Operand for each of the row's 3 operand types.
+//-----------------------------------------------------------------------------------------------
+size_t Encoder::Encode(const OpCodeEntry *row, const Operand *ops, uint32_t address, uint8_t *out,
+        Field *fields)
+{
+    uint8_t *p = out;
+    int rm = -1;
+    int reg = -1;
+
+    auto field = [&](int i, const uint8_t *end, uint8_t size, bool relative) {
+        if (fields) fields[i] = Field { (uint8_t)(end - size - out), size, relative };
+    };
+
+    if (fields) for (int i = 0; i < 3; i ++) fields[i] = Field { 0, 0, false };
+
+    for (int i = 0; i < 3; i ++) {
+        if (ops[i].IsMemory() && ops[i].seg != R_NONE) *p ++ = segPrefix[ops[i].seg - R_ES];
+
+        switch (row->type[i]) {
+        case RM8: case RM16: case M: case M8: case M16: case M16_16:
+            rm = i;
+            break;
+
+        case R8: case R16: case SREG:
+            reg = i;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    memcpy(p, row->byteCode, row->opcodeBytes);
+    p += row->opcodeBytes;
+
+    if (rm >= 0) {
+        uint8_t r = (row->modRM_Part ? row->modRM_Op : reg >= 0 ? RegCode(ops[reg].reg) : 0);
+        p = ModRM(p, r, ops[rm]);
+
+        // -- only a word displacement is recorded; that is always the case for a label
+        const Operand &m = ops[rm];
+        if (m.IsMemory() && ((m.base == R_NONE && m.index == R_NONE) || m.IsRelocatable())) {
+            field(rm, p, 2, false);
+        }
+    } else if (reg >= 0) p[-1] += RegCode(ops[reg].reg);
+
+    for (int i = 0; i < 3; i ++) {
+        const Operand &op = ops[i];
+
+        switch (row->type[i]) {
+        case IMM8:
+            *p ++ = (uint8_t)op.value;
+            field(i, p, 1, false);
+            break;
+
+        case IMM16:
+        case MOFFS8:
+        case MOFFS16:
+            p = Put16(p, op.value);
+            field(i, p, 2, false);
+            break;
+
+        case PTR16_16:
+            p = Put16(p, op.value);
+            field(i, p, 2, false);
+            p = Put16(p, op.segment);
+            break;
+
+        case REL8: {
+            int64_t rel = op.value - (address + (p + 1 - out));
+
+            if (rel < -128 || rel > 127) return 0;
+            *p ++ = (uint8_t)rel;
+            field(i, p, 1, true);
+            break;
+        }
+
+        case REL16:
+            p = Put16(p, op.value - (address + (p + 2 - out)));
+            field(i, p, 2, true);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return p - out;
+}
+
+//===============================================================================================
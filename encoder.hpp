@@ -0,0 +1,61 @@
+//===============================================================================================
+// encoder.hpp -- This file contains the class definition for turning an instruction into bytes.
+//
+// The encoder takes the OpCodeEntry row chosen for an instruction and its parsed Operands and
+// writes the machine code: any segment override prefix, the opcode bytes, the ModR/M byte and
+// displacement, and the immediates, in that order.  The row says how:
+//
+// * An RM (or M) operand is encoded in the ModR/M r/m field.  When modRM_Part is Y the reg field
+//   is the opcode extension modRM_Op (`/digit`); otherwise it is the R or SREG operand (`/r`).
+// * A row with an R operand but no RM operand (MOV r,imm) adds the register to the opcode (`+r`).
+// * IMMn, MOFFSn, RELn, and PTR16_16 operands follow, in operand order.
+//
+// Only 16-bit addressing is supported, as that is all the OpCodeTable has so far.  The
+// displacement of a memory operand that refers to a label is always 16 bits, since its final
+// value is not known until the Relaxer has run.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-012   Initial version
+// 2026-10-16  ADCL   U-013   Encode() reports where each operand's field is, for the fixups
+//
+//===============================================================================================
+
+#ifndef __ENCODER_HPP__
+#define __ENCODER_HPP__
+
+#ifndef __cplusplus
+#error The file 'encoder.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "OpCodeTable.h"
+#include "operand.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------------
+// The Encoder class has no state; it is a class for the same reason the Lexer is.  Encode()
+// writes at most MAX_LENGTH bytes to out and returns the number written.  It returns 0 when the
+// row cannot encode the values -- a REL8 whose target is out of range -- so that the caller can
+// try the next candidate row.  If fields is given, fields[i] is set to where the value of
+// ops[i] was written (size 0 if it was not written anywhere).
+//-----------------------------------------------------------------------------------------------
+class Encoder {
+public:
+    static const size_t MAX_LENGTH = 15;
+
+    struct Field {
+        uint8_t offset;             // from the start of the instruction
+        uint8_t size;               // 1 or 2 bytes; 0 for none
+        bool relative;              // a RELn field
+    };
+
+public:
+    static size_t Encode(const OpCodeEntry *row, const Operand *ops, uint32_t address, uint8_t *out,
+            Field *fields = NULL);
+};
+
+//===============================================================================================
+
+#endif
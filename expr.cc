@@ -0,0 +1,81 @@
+//===============================================================================================
+// expr.cc -- This file contains the implementation of the expression pool.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-017   Initial version
+//
+//===============================================================================================
+
+#include "expr.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// ExprPool::Leaf(const ExprValue&, uint32_t) returns a node for a value that was folded, so that
+// it can become an operand of a node that cannot be.  pos is the staging offset for a `$`.
+//-----------------------------------------------------------------------------------------------
+uint32_t ExprPool::Leaf(const ExprValue &v, uint32_t pos)
+{
+    if (v.node) return v.node;
+    if (v.sym) return Add(ExprNode { EX_SYM, 0, 0, 0, v.k, v.sym });
+    if (v.here) return Add(ExprNode { EX_HERE, 0, 0, pos, v.k, NULL });
+    return Add(ExprNode { EX_CONST, 0, 0, 0, v.k, NULL });
+}
+
+//-----------------------------------------------------------------------------------------------
+// ExprPool::BinaryOp(TokenType) and ExprPool::Precedence(TokenType) describe the binary
+// operators.  From the loosest: `|`, `^`, `&`, the shifts, `+ -`, and `* / %`.  Anything that
+// is not a binary operator has a precedence of 0.
+//-----------------------------------------------------------------------------------------------
+ExprOp ExprPool::BinaryOp(TokenType t)
+{
+    switch (t) {
+    case TOK_PLUS: return EX_ADD;
+    case TOK_MINUS: return EX_SUB;
+    case TOK_STAR: return EX_MUL;
+    case TOK_SLASH: return EX_DIV;
+    case TOK_PERCENT: return EX_MOD;
+    case TOK_SHL: return EX_SHL;
+    case TOK_SHR: return EX_SHR;
+    case TOK_AMP: return EX_AND;
+    case TOK_PIPE: return EX_OR;
+    default: return EX_XOR;
+    }
+}
+
+int ExprPool::Precedence(TokenType t)
+{
+    switch (t) {
+    case TOK_PIPE: return 1;
+    case TOK_CARET: return 2;
+    case TOK_AMP: return 3;
+    case TOK_SHL: case TOK_SHR: return 4;
+    case TOK_PLUS: case TOK_MINUS: return 5;
+    case TOK_STAR: case TOK_SLASH: case TOK_PERCENT: return 6;
+    default: return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// ExprPool::Fold(ExprOp, int64_t, int64_t, int64_t&) applies a binary operator to 2 constants.
+// It returns false for a division by 0.  `>>` is a logical shift.
+//-----------------------------------------------------------------------------------------------
+bool ExprPool::Fold(ExprOp op, int64_t a, int64_t b, int64_t &v)
+{
+    switch (op) {
+    case EX_ADD: v = a + b; break;
+    case EX_SUB: v = a - b; break;
+    case EX_MUL: v = a * b; break;
+    case EX_DIV: if (!b) return false; v = a / b; break;
+    case EX_MOD: if (!b) return false; v = a % b; break;
+    case EX_SHL: v = (b < 0 || b > 63 ? 0 : (int64_t)((uint64_t)a << b)); break;
+    case EX_SHR: v = (b < 0 || b > 63 ? 0 : (int64_t)((uint64_t)a >> b)); break;
+    case EX_AND: v = a & b; break;
+    case EX_OR: v = a | b; break;
+    case EX_XOR: v = a ^ b; break;
+    default: return false;
+    }
+
+    return true;
+}
+
+//===============================================================================================
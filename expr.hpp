@@ -0,0 +1,167 @@
+//===============================================================================================
+// expr.hpp -- This file contains the definitions for operand expressions.
+//
+// Most expressions in a source file are constants -- `10`, `BUF_SIZE * 2`, `0x7c00 + 0x200` --
+// or a label plus a constant.  The Parser folds those as it parses them, into an ExprValue, and
+// nothing is kept but the number (and the label).  Only an expression whose value depends on
+// where labels end up in some other way (`$ - msg`, `(end - start) / 2`) needs to be kept until
+// the Relaxer has settled the addresses.  Those are stored as ExprNodes in an ExprPool: a flat
+// vector of small POD nodes that refer to each other by index, so an expression costs a few
+// entries in a vector rather than a tree on the heap.
+//
+// Since a `$` that is kept cannot mean the instruction that happens to use it later (an EQU
+// made of `$` is used elsewhere), an EX_HERE node holds the staging offset it was written at.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-017   Initial version
+//
+//===============================================================================================
+
+#ifndef __EXPR_HPP__
+#define __EXPR_HPP__
+
+#ifndef __cplusplus
+#error The file 'expr.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "lexer.hpp"
+#include "symtab.h"
+
+#include <cstdint>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// These are the node types.  EX_SYM is a symbol plus value; EX_HERE is the address of the
+// staging offset pos plus value.
+//-----------------------------------------------------------------------------------------------
+typedef enum : uint8_t {
+    EX_CONST,
+    EX_SYM,
+    EX_HERE,
+    EX_NEG,
+    EX_NOT,
+    EX_ADD,
+    EX_SUB,
+    EX_MUL,
+    EX_DIV,
+    EX_MOD,
+    EX_SHL,
+    EX_SHR,
+    EX_AND,
+    EX_OR,
+    EX_XOR,
+} ExprOp;
+
+//-----------------------------------------------------------------------------------------------
+// An ExprNode.  a and b are the operands of an operator (b is unused for EX_NEG and EX_NOT).
+//-----------------------------------------------------------------------------------------------
+struct ExprNode {
+    ExprOp op;
+    uint32_t a;
+    uint32_t b;
+    uint32_t pos;                   // EX_HERE
+    int64_t value;                  // EX_CONST, EX_SYM, EX_HERE
+    Symbol *sym;                    // EX_SYM
+};
+
+//-----------------------------------------------------------------------------------------------
+// An ExprValue is the result of parsing an expression.  It is exactly one of: a constant (k); a
+// symbol or `$` plus a constant; or a node in the ExprPool.  Inside a memory reference it also
+// carries the base and index registers, which may only be added.
+//-----------------------------------------------------------------------------------------------
+struct ExprValue {
+    int64_t k;
+    Symbol *sym;
+    bool here;
+    uint32_t node;                  // 0 if the value is not deferred
+    uint8_t base;
+    uint8_t index;
+
+    ExprValue(void) : k(0), sym(NULL), here(false), node(0), base(R_NONE), index(R_NONE) {};
+
+    bool IsConstant(void) const { return !sym && !here && !node; };
+    bool HasRegisters(void) const { return base != R_NONE || index != R_NONE; };
+};
+
+//-----------------------------------------------------------------------------------------------
+// The ExprPool class.  Node 0 is never used, so that 0 can mean "no node".
+//
+// Evaluate() computes a node given a function that resolves EX_SYM and EX_HERE leaves:
+//
+//     bool resolve(const ExprNode &leaf, int64_t &value, int &relocs);
+//
+// relocs counts the section addresses in the value (+1 for each added, -1 for each subtracted),
+// so that a caller writing an object file can tell whether the result is a constant (0), an
+// address in the section (1), or something no relocation can express.  An operator other than
+// +, -, or negation applied to an address gives -100 (never a valid count).  Evaluate() returns
+// false if a leaf could not be resolved or there was a division by 0.
+//-----------------------------------------------------------------------------------------------
+class ExprPool {
+public:
+    ExprPool(void) : nodes(1) {};
+    virtual ~ExprPool() {};
+
+private:
+    ExprPool(const ExprPool &);
+    ExprPool &operator=(const ExprPool &);
+
+public:
+    uint32_t Add(const ExprNode &n) { nodes.push_back(n); return (uint32_t)(nodes.size() - 1); };
+    uint32_t Leaf(const ExprValue &v, uint32_t pos);
+    const ExprNode &operator[](uint32_t i) const { return nodes[i]; };
+    size_t Count(void) const { return nodes.size() - 1; };
+
+    template <typename R>
+    bool Evaluate(uint32_t i, const R &resolve, int64_t &value, int &relocs) const;
+
+    static ExprOp BinaryOp(TokenType t);
+    static int Precedence(TokenType t);
+    static bool Fold(ExprOp op, int64_t a, int64_t b, int64_t &v);
+
+private:
+    std::vector<ExprNode> nodes;
+};
+
+//-----------------------------------------------------------------------------------------------
+// ExprPool::Evaluate(...) is a template, so it is defined here.
+//-----------------------------------------------------------------------------------------------
+template <typename R>
+bool ExprPool::Evaluate(uint32_t i, const R &resolve, int64_t &value, int &relocs) const
+{
+    const ExprNode &n = nodes[i];
+    int64_t a, b;
+    int ra = 0, rb = 0;
+
+    switch (n.op) {
+    case EX_CONST:
+        value = n.value;
+        relocs = 0;
+        return true;
+
+    case EX_SYM:
+    case EX_HERE:
+        return resolve(n, value, relocs);
+
+    case EX_NEG:
+    case EX_NOT:
+        if (!Evaluate(n.a, resolve, a, ra)) return false;
+        value = (n.op == EX_NEG ? -a : ~a);
+        relocs = (n.op == EX_NEG ? -ra : (ra ? -100 : 0));
+        return true;
+
+    default:
+        if (!Evaluate(n.a, resolve, a, ra) || !Evaluate(n.b, resolve, b, rb)) return false;
+        if (!Fold(n.op, a, b, value)) return false;
+
+        if (n.op == EX_ADD) relocs = ra + rb;
+        else if (n.op == EX_SUB) relocs = ra - rb;
+        else relocs = (ra || rb ? -100 : 0);
+
+        return true;
+    }
+}
+
+//===============================================================================================
+
+#endif
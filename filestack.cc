@@ -0,0 +1,265 @@
+//===============================================================================================
+// filestack.cc -- This file contains the class implementation for managing a stack of input
+// files, along with the process-wide include file cache.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-019   Record the files included
+// 2026-10-16  ADCL   U-021   Relative names may be from a directory other than the current one
+// 2026-10-16  ADCL   U-023   A file is lexed ahead as its first line is read
+// 2026-10-16  ADCL   U-024   Or piped
+// 2026-10-16  ADCL   U-025   Count the includes and the lines read from each file into a Stats
+// 2026-10-16  ADCL   U-021   The include cache is bounded (LRU); a long-lived process copies files
+// 2026-10-16  ADCL   U-021   File names are registered in the stack's own SourceFiles
+//
+//===============================================================================================
+
+#include "filestack.hpp"
+
+#include <atomic>
+#include <climits>
+#include <ios>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+//-----------------------------------------------------------------------------------------------
+// This is how deeply includes may be nested before we assume a file is including itself.
+//-----------------------------------------------------------------------------------------------
+static const int MAX_DEPTH = 64;
+
+//-----------------------------------------------------------------------------------------------
+// These bound the include cache: the bytes it keeps, and the files (each of which may be a
+// mapping).
+//-----------------------------------------------------------------------------------------------
+static const size_t CACHE_BYTES = 64 * 1024 * 1024;
+static const size_t CACHE_FILES = 1024;
+
+//-----------------------------------------------------------------------------------------------
+// The include cache.  An entry is only used if the file still has the mtime and size it had
+// when it was read; otherwise it is read again and the entry replaced.  The entries are kept in
+// the order they were last used, and once the cache holds more than CACHE_BYTES or CACHE_FILES
+// the least recently used are dropped -- but only those that no InputFile is reading, since an
+// entry still in use would not give its memory back.  The cache is shared by every FileStack in
+// the process, so it is protected by a mutex.
+//-----------------------------------------------------------------------------------------------
+struct CacheEntry {
+    std::shared_ptr<const MappedFile> contents;
+    struct timespec mtime;
+    off_t size;
+    std::list<std::string>::iterator use;   // where the path is in cacheOrder
+};
+
+static std::mutex cacheLock;
+static std::unordered_map<std::string, CacheEntry> includeCache;
+static std::list<std::string> cacheOrder;   // the paths cached, the most recently used first
+static size_t cacheBytes;
+
+//-----------------------------------------------------------------------------------------------
+// A long-lived process reads files into memory rather than mapping them (see SetLongLived()).
+//-----------------------------------------------------------------------------------------------
+static std::atomic<bool> longLived(false);
+
+static std::shared_ptr<const MappedFile> Contents(const std::string &path)
+{
+    if (longLived.load(std::memory_order_relaxed)) return MappedFile::Read(path);
+    return MappedFile::Open(path);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Trim() drops the least recently used entries that nothing else holds until the cache is within
+// its bounds again (or everything left is in use).  The cache lock is held.
+//-----------------------------------------------------------------------------------------------
+static void Trim(void)
+{
+    std::list<std::string>::iterator p = cacheOrder.end();
+
+    while (p != cacheOrder.begin()
+            && (cacheBytes > CACHE_BYTES || includeCache.size() > CACHE_FILES)) {
+        std::unordered_map<std::string, CacheEntry>::iterator i = includeCache.find(*-- p);
+
+        if (i->second.contents.use_count() > 1) continue;
+
+        cacheBytes -= i->second.contents->Size();
+        includeCache.erase(i);
+        p = cacheOrder.erase(p);
+    }
+}
+
+static std::shared_ptr<const MappedFile> CachedContents(const std::string &path,
+        const struct stat &st)
+{
+    std::lock_guard<std::mutex> guard(cacheLock);
+    std::unordered_map<std::string, CacheEntry>::iterator i = includeCache.find(path);
+
+    if (i != includeCache.end() && i->second.size == st.st_size
+            && i->second.mtime.tv_sec == st.st_mtim.tv_sec
+            && i->second.mtime.tv_nsec == st.st_mtim.tv_nsec) {
+        cacheOrder.splice(cacheOrder.begin(), cacheOrder, i->second.use);
+        return i->second.contents;
+    }
+
+    std::shared_ptr<const MappedFile> contents = Contents(path);
+
+    if (i == includeCache.end()) {
+        i = includeCache.emplace(path, CacheEntry()).first;
+        cacheOrder.push_front(path);
+    } else {
+        cacheBytes -= i->second.contents->Size();
+        cacheOrder.splice(cacheOrder.begin(), cacheOrder, i->second.use);
+    }
+
+    CacheEntry &e = i->second;
+    e.contents = contents;
+    e.mtime = st.st_mtim;
+    e.size = st.st_size;
+    e.use = cacheOrder.begin();
+    cacheBytes += contents->Size();
+
+    Trim();
+
+    return contents;
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::SetLongLived(bool) says whether the process keeps running from one assembly to the
+// next.  Its files are then read into memory, never mapped: a cached mapping would be held for
+// a long time, and a file truncated while it is mapped faults (SIGBUS) the whole process.
+//-----------------------------------------------------------------------------------------------
+void FileStack::SetLongLived(bool l)
+{
+    longLived.store(l, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::~FileStack() closes any files that are still open.
+//-----------------------------------------------------------------------------------------------
+FileStack::~FileStack()
+{
+    while (stack) Pop();
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::Resolve(const std::string&) finds an include file.  A relative name is looked for
+// first beside the file that includes it, then in each include path, and finally relative to
+// the current directory (or the one given to SetDirectory()).  If it is not found anywhere, the
+// name is returned unchanged and the open will fail.
+//-----------------------------------------------------------------------------------------------
+std::string FileStack::Resolve(const std::string &f)
+{
+    struct stat st;
+
+    if (f[0] == '/' || !stack) return f;
+
+    std::string::size_type slash = stack->FileName().rfind('/');
+    if (slash != std::string::npos) {
+        std::string p = stack->FileName().substr(0, slash + 1) + f;
+        if (stat(Full(p).c_str(), &st) == 0) return p;
+    }
+
+    for (size_t i = 0; i < includePaths.size(); i ++) {
+        std::string p = includePaths[i] + "/" + f;
+        if (stat(Full(p).c_str(), &st) == 0) return p;
+    }
+
+    return f;
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::Push(const std::string&) opens a file and makes it the current file.  The top-level
+// file is mapped directly (by its canonical path, since its name may be relative to another
+// directory); only included files go through the cache.
+//-----------------------------------------------------------------------------------------------
+bool FileStack::Push(const std::string &f)
+{
+    InputFile *in;
+
+    if (depth >= MAX_DEPTH) throw std::runtime_error("Includes are nested too deeply");
+
+    if (f == "") {
+        in = new InputFile("", 0);
+    } else {
+        std::string path = Resolve(f);
+        char canon[PATH_MAX];
+        struct stat st;
+
+        if (!realpath(Full(path).c_str(), canon) || stat(canon, &st) < 0) {
+            throw std::ios_base::failure("Unable to open file " + f);
+        }
+
+        if (once.count(canon)) return false;
+
+        if (stack) {
+            in = new InputFile(path, files.Register(path), CachedContents(canon, st));
+            if (seen.insert(canon).second) included.push_back(canon);
+            if (stats) stats->pushes ++;
+        } else in = new InputFile(path, files.Register(path), Contents(canon));
+
+        in->SetPath(canon);
+    }
+
+    in->SetNext(stack);
+    stack = in;
+    depth ++;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::Pop() closes the current file and returns to the one that included it.
+//-----------------------------------------------------------------------------------------------
+void FileStack::Pop(void)
+{
+    InputFile *top = stack;
+
+    if (!top) return;
+
+    if (stats) {
+        stats->lines[top->FileName()] += top->LineNum();
+        if (top->Next()) stats->pops ++;
+    }
+
+    stack = top->Next();
+    depth --;
+    delete top;
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::ReadLine(std::string_view&) reads the next line, closing files as they reach their
+// EOF.  It returns false when the last file on the stack has been read.  A file is piped or lexed
+// ahead (if it is large, and there are the threads to do it) as its first line is read.
+//-----------------------------------------------------------------------------------------------
+bool FileStack::ReadLine(std::string_view &line)
+{
+    while (stack) {
+        if (!stack->IsEOF()) {
+            if (stack->LineNum() == 0) {
+                if (pipeline) stack->Pipeline();
+                else if (lexThreads > 1) stack->LexAhead(lexThreads, stats);
+            }
+
+            line = stack->ReadLine();
+            return true;
+        }
+
+        Pop();
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// FileStack::MarkOnce() marks the current file so that any later include of it is skipped.
+//-----------------------------------------------------------------------------------------------
+void FileStack::MarkOnce(void)
+{
+    if (stack && stack->Path() != "") once.insert(stack->Path());
+}
+
+//===============================================================================================
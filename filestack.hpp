@@ -5,10 +5,44 @@
 // to a directive that includes a file, I will push a new Input File onto the stack and all
 // references to read the file are pulled from this new file until it reaches its EOF.
 //
+// Include files are read from disk only once per process.  The contents of every included file
+// are kept (mapped) in a cache keyed by the canonical path, and the cached copy is used as long
+// as the file's mtime and size have not changed.  The cache is bounded, in bytes and in files,
+// and drops the files least recently used.  A process that keeps running (the server) calls
+// SetLongLived(), and its files are then read into memory rather than mapped.  In addition, a
+// file that contains the ONCE directive is skipped entirely if it is included again by the same
+// translation unit.
+//
+// Relative names are taken from the directory given to SetDirectory(), if any, rather than the
+// current directory -- a server assembles for clients that each have their own.
+//
+// Every file opened is registered in the stack's own SourceFiles, so the FileIds in a SrcLoc are
+// named by Files() of the stack that read them.
+//
+// The canonical path of every file included is also recorded, once each and in the order first
+// seen, for the assembly cache.
+//
+// Given more than one thread by SetLexThreads(), the stack has each large file lexed ahead, in
+// parallel, just before its first line is read; Tokens() then has the tokens of each line.
+// With SetPipeline(), a large file is instead piped: read and lexed on threads of its own, a few
+// batches of lines ahead of the Parser.
+//
+// Given a Stats by SetStats(), the stack counts the includes pushed and popped and the lines read
+// from each file (as each is popped), and times any lexing ahead.
+//
 //    Date     PGMR  Tracker  Description
 // ----------  ----  -------  -------------------------------------------------------------------
 // 2015-02-09  ADCL  Initial  This is the first version.  This is completed based on Redmine
 //                            #264.
+// 2026-10-16  ADCL   U-007   Added FileNum() and Location() from the source file registry
+// 2026-10-16  ADCL   U-008   Implemented the stack, with an include cache and include-once
+// 2026-10-16  ADCL   U-019   Added Included() for the assembly cache
+// 2026-10-16  ADCL   U-021   Added SetDirectory()
+// 2026-10-16  ADCL   U-023   Large files are lexed ahead on SetLexThreads() threads
+// 2026-10-16  ADCL   U-024   Or piped, with SetPipeline()
+// 2026-10-16  ADCL   U-025   Added SetStats()
+// 2026-10-16  ADCL   U-021   The include cache is bounded; added SetLongLived()
+// 2026-10-16  ADCL   U-021   Each stack has its own SourceFiles registry, given by Files()
 //
 //===============================================================================================
 
@@ -16,13 +50,15 @@
 #define __FILESTACK_HPP__
 
 #ifndef __cplusplus
-#error The file 'parser.hpp' is not being compiled by a C++ compiler.
+#error The file 'filestack.hpp' is not being compiled by a C++ compiler.
 #endif
 
 #include "in-file.hpp"
 
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
 
 //-----------------------------------------------------------------------------------------------
 // The class FileStack exists to automatically manage and maintain a stack of files.  One asm
@@ -30,26 +66,63 @@
 // file reaches its end of file, FileStack needs to automatically close the top file on the
 // stack and pop it off the stack.  In the meantime, the original file is not considered to be
 // closed until it reaches its own EOF.
+//
+// Push() returns false if the file was skipped because it was already included and marked with
+// MarkOnce().  It throws std::ios_base::failure if the file cannot be found or read, and
+// std::runtime_error if the includes are nested too deeply (which is usually a file including
+// itself).  An empty name pushes stdin.
 //-----------------------------------------------------------------------------------------------
 class FileStack {
 public:
-    FileStack(void) : stack(NULL) {};
+    FileStack(void) : stack(NULL), depth(0), lexThreads(1), pipeline(false), stats(NULL) {};
     virtual ~FileStack();
 
+private:
+    FileStack(const FileStack &);
+    FileStack &operator=(const FileStack &);
+
 public:
-    void Push(const std::string &f);
-    void Push(std::ifstream &f);
+    bool Push(const std::string &f);
     void Pop(void);
+    bool ReadLine(std::string_view &line);
+    bool Tokens(const Token *&first, size_t &count) const {
+        return stack && stack->Tokens(first, count);
+    };
+    void MarkOnce(void);
+    void AddIncludePath(const std::string &dir) { includePaths.push_back(dir); };
+    void SetDirectory(const std::string &d) { dir = d; };
+    void SetLexThreads(unsigned n) { lexThreads = n; };
+    void SetPipeline(bool p) { pipeline = p; };
+    void SetStats(Stats *s) { stats = s; };
+
+    static void SetLongLived(bool l);
 
 public:
     std::string FileName(void) { return (stack?stack->FileName():""); };
     long LineNum(void) { return (stack?stack->LineNum():0); };
+    FileId FileNum(void) { return (stack?stack->FileNum():0); };
+    SrcLoc Location(void) { return (stack?stack->Location():SrcLoc { 0, 0 }); };
+    int Depth(void) const { return depth; };
+    const std::vector<std::string> &Included(void) const { return included; };
+    const SourceFiles &Files(void) const { return files; };
 
 private:
-    InputFile *stack;
+    std::string Resolve(const std::string &f);
+    std::string Full(const std::string &f) const
+            { return (dir.empty() || f.empty() || f[0] == '/' ? f : dir + "/" + f); };
 
 private:
-    std::string ReadLine(void);
+    InputFile *stack;
+    int depth;
+    std::unordered_set<std::string> once;   // canonical paths of the files marked ONCE
+    std::unordered_set<std::string> seen;   // canonical paths of the files included
+    std::vector<std::string> included;      // the same, in the order first included
+    std::vector<std::string> includePaths;
+    std::string dir;                        // where relative names are from; "" for the current one
+    unsigned lexThreads;                    // the threads a large file is lexed ahead on
+    bool pipeline;                          // large files are piped instead
+    Stats *stats;                           // what to count into, or NULL
+    SourceFiles files;                      // the names of the files opened, by FileId
 };
 
 //===============================================================================================
@@ -4,6 +4,13 @@
 //    Date     PGMR  Tracker  Description
 // ----------  ----  -------  -------------------------------------------------------------------
 // 2015-01-29  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-001   Read through mmap() and return string_view slices of the mapping
+// 2026-10-16  ADCL   U-007   Register the file name in the source file registry
+// 2026-10-16  ADCL   U-008   The mapping is now a shared MappedFile
+// 2026-10-16  ADCL   U-023   Added LexAhead() and Tokens(); ReadLine() splits lines with TakeLine()
+// 2026-10-16  ADCL   U-024   Added Pipeline()
+// 2026-10-16  ADCL   U-025   LexAhead() records a Span, if it is given a Stats
+// 2026-10-16  ADCL   U-021   Added MappedFile::Read(); the FileId is given to the constructors
 //
 //===============================================================================================
 
@@ -11,56 +18,246 @@
 #include "parser.hpp"
 #include "utils.hpp"
 
+#include <cerrno>
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//-----------------------------------------------------------------------------------------------
+// This is the size of the buffer we start with when reading from stdin.  It will grow if a
+// single line does not fit.
+//-----------------------------------------------------------------------------------------------
+static const size_t STDIN_BUFFER = 64 * 1024;
+
+//-----------------------------------------------------------------------------------------------
+// A file smaller than this is not worth the threads to lex it ahead; one larger than the token
+// indexes of a LexedText can hold cannot be.
 //-----------------------------------------------------------------------------------------------
-// InputFile::InputFile(const std::string&) is the standard consutructor for the InputFile class.
-// It is also responsible for pushing itself onto the stack as the current open file.
+static const size_t LEX_AHEAD_MIN = 1024 * 1024;
+static const size_t LEX_AHEAD_MAX = 0xffffffffu;
+
 //-----------------------------------------------------------------------------------------------
-InputFile::InputFile(const std::string &name) : file(NULL), next(NULL), fileName(name),
-        lineNum(0)
+// A file smaller than this is read and lexed before the pipeline's threads would have started.
+//-----------------------------------------------------------------------------------------------
+static const size_t PIPELINE_MIN = 64 * 1024;
+
+//-----------------------------------------------------------------------------------------------
+// MappedFile::Open(const std::string&) opens name and maps it into memory.  An empty file has
+// nothing to map, so it is simply a MappedFile with a size of 0.
+//-----------------------------------------------------------------------------------------------
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string &name)
 {
-    if (name != "") {
-        file = new std::ifstream();
-        file->exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        file->open(name.c_str());
+    std::shared_ptr<MappedFile> rv(new MappedFile());
+    struct stat st;
+    int fd;
+
+    fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) throw std::ios_base::failure("Unable to open file " + name);
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::ios_base::failure("Unable to stat file " + name);
     }
+
+    if (st.st_size) {
+        void *m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (m == MAP_FAILED) {
+            close(fd);
+            throw std::ios_base::failure("Unable to map file " + name);
+        }
+
+        madvise(m, st.st_size, MADV_SEQUENTIAL);
+        rv->base = static_cast<const char *>(m);
+        rv->size = st.st_size;
+    }
+
+    // -- the mapping stays valid after the descriptor is closed
+    close(fd);
+
+    return rv;
 }
 
 //-----------------------------------------------------------------------------------------------
-// ~InputFile::InputFile() is used to clean up an InputFile.  Remember that next is a pointer to
-// an instance that will persist after this instance is cleaned up, so we will not delete it.
+// MappedFile::Read(const std::string&) opens name and reads it into a buffer of its own.  A file
+// that shrinks while it is read is simply shorter.
 //-----------------------------------------------------------------------------------------------
-InputFile::~InputFile()
+std::shared_ptr<const MappedFile> MappedFile::Read(const std::string &name)
 {
-    if (file) {
-        file->close();
-        delete file;
+    std::shared_ptr<MappedFile> rv(new MappedFile());
+    struct stat st;
+    int fd;
+
+    fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0) throw std::ios_base::failure("Unable to open file " + name);
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::ios_base::failure("Unable to stat file " + name);
     }
+
+    if (st.st_size) {
+        rv->copy.reset(new char[st.st_size]);
+
+        while (rv->size < (size_t)st.st_size) {
+            ssize_t n = read(fd, rv->copy.get() + rv->size, st.st_size - rv->size);
+
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                close(fd);
+                throw std::ios_base::failure("Unable to read file " + name);
+            }
+            if (n == 0) break;
+
+            rv->size += n;
+        }
+
+        rv->base = rv->copy.get();
+    }
+
+    close(fd);
+
+    return rv;
 }
 
 //-----------------------------------------------------------------------------------------------
-// InputFile::ReadLine is the worker function to read a line from the associated file.  eof()
-// must be checked before calling this function for the stack to work.
+// MappedFile::~MappedFile() releases the mapping (a copy releases itself).
 //-----------------------------------------------------------------------------------------------
-std::string InputFile::ReadLine(void)
+MappedFile::~MappedFile()
 {
-    std::string line;
+    if (base && !copy) munmap(const_cast<char *>(base), size);
+}
 
-    if (file) {
-        if (getline(*file, line)) {
-            lineNum ++;
-            line = rtrim(line, "\x1a");
-        }
+//-----------------------------------------------------------------------------------------------
+// InputFile::InputFile(const std::string&, FileId) is the standard consutructor for the InputFile
+// class.  A named file is opened and mapped into memory; an empty name reads from stdin.
+//-----------------------------------------------------------------------------------------------
+InputFile::InputFile(const std::string &name, FileId id) : mapped(false), inputEOF(false),
+        base(NULL), size(0), pos(0), next(NULL), fileName(name), fileNum(id), lineNum(0)
+{
+    if (name != "") {
+        contents = MappedFile::Open(name);
+        mapped = true;
+        base = contents->Data();
+        size = contents->Size();
     } else {
-        if (getline(std::cin, line)) {
-            lineNum ++;
-            line = rtrim(line, "\x1a");
+        buffer.resize(STDIN_BUFFER);
+        base = &buffer[0];
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// InputFile::InputFile(const std::string&, FileId, std::shared_ptr<const MappedFile>) reads from
+// contents that have already been mapped (by the FileStack include cache).
+//-----------------------------------------------------------------------------------------------
+InputFile::InputFile(const std::string &name, FileId id, std::shared_ptr<const MappedFile> c)
+        : contents(c), mapped(true), inputEOF(false), base(c->Data()), size(c->Size()), pos(0),
+        next(NULL), fileName(name), fileNum(id), lineNum(0)
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// InputFile::Fill() makes sure that a complete line is available in the stdin buffer (or that
+// we have reached EOF).  Any partial line is moved to the front of the buffer before reading
+// more; the buffer is only grown when one line will not fit.
+//-----------------------------------------------------------------------------------------------
+void InputFile::Fill(void)
+{
+    while (!inputEOF && !memchr(base + pos, '\n', size - pos)) {
+        if (pos) {
+            memmove(&buffer[0], &buffer[pos], size - pos);
+            size -= pos;
+            pos = 0;
         }
+
+        if (size == buffer.size()) buffer.resize(buffer.size() * 2);
+        base = &buffer[0];
+
+        ssize_t cnt = read(STDIN_FILENO, &buffer[size], buffer.size() - size);
+        if (cnt < 0) throw std::ios_base::failure("Unable to read from stdin");
+        if (cnt == 0) inputEOF = true;
+        size += cnt;
     }
+}
+
+//-----------------------------------------------------------------------------------------------
+// InputFile::ReadLine is the worker function to read a line from the associated file.  eof()
+// must be checked before calling this function for the stack to work.  The line terminator, any
+// carriage return, and any trailing DOS EOF (0x1a) are excluded from the returned view.  A piped
+// file has its lines split by the pipe.
+//-----------------------------------------------------------------------------------------------
+std::string_view InputFile::ReadLine(void)
+{
+    if (pipe) {
+        std::string_view line;
+
+        if (!pipe->Next(line)) return std::string_view();
+
+        lineNum ++;
+        return line;
+    }
+
+    if (!mapped) Fill();
+    if (pos >= size) return std::string_view();
+
+    const char *p = base + pos;
+    std::string_view line = TakeLine(p, base + size);
+
+    pos = p - base;
+    lineNum ++;
 
     return line;
 }
 
+//-----------------------------------------------------------------------------------------------
+// InputFile::LexAhead(unsigned, Stats*) lexes the whole of a large mapped file on up to threads
+// threads, if no line has been read yet.  Anything else is left to be lexed a line at a time.
+//-----------------------------------------------------------------------------------------------
+void InputFile::LexAhead(unsigned threads, Stats *stats)
+{
+    if (!mapped || !contents || lexed || pipe || lineNum || threads < 2) return;
+    if (size < LEX_AHEAD_MIN || size >= LEX_AHEAD_MAX) return;
+
+    StageTimer timer(stats, "lex ahead");
+
+    lexed.reset(new LexedText);
+    Lexer().LexLines(std::string_view(base, size), threads, *lexed);
+}
+
+//-----------------------------------------------------------------------------------------------
+// InputFile::Pipeline() hands a mapped file to a LinePipe, if no line has been read yet and the
+// file is large enough to be worth it.  Anything else is read and lexed a line at a time.
+//-----------------------------------------------------------------------------------------------
+void InputFile::Pipeline(void)
+{
+    if (!mapped || !contents || lexed || pipe || lineNum || size < PIPELINE_MIN) return;
+
+    pipe.reset(new LinePipe(base, size));
+}
+
+//-----------------------------------------------------------------------------------------------
+// InputFile::Tokens(const Token*&, size_t&) gives the tokens of the line ReadLine() last
+// returned, if the file was lexed ahead or is piped; otherwise it returns false.
+//-----------------------------------------------------------------------------------------------
+bool InputFile::Tokens(const Token *&first, size_t &count) const
+{
+    if (pipe) {
+        if (lineNum < 1) return false;
+
+        pipe->Tokens(first, count);
+        return true;
+    }
+
+    if (!lexed || lineNum < 1 || (size_t)lineNum > lexed->lineCount) return false;
+
+    first = &lexed->tokens[lexed->lines[lineNum - 1]];
+    count = lexed->lines[lineNum] - lexed->lines[lineNum - 1];
+    return true;
+}
+
 //===============================================================================================
@@ -6,6 +6,24 @@
 // and then push the "included" file onto a stack of input files.  When a file closes, it's just
 // a matter of poping the instance off the stack and resetting a pointer.
 //
+// A named file is mapped into memory in its entirety and each line is handed back as a
+// std::string_view into that mapping -- no copies are made of the source.  Standard input cannot
+// be mapped, so it is read through a buffer instead; the line is then a view into that buffer.
+//
+// The mapping itself is a MappedFile, which is reference counted.  This lets the FileStack keep
+// the contents of an include file around and hand the same mapping to every InputFile that
+// includes it, rather than mapping the file again.  A MappedFile may instead hold a copy of the
+// file, read into memory with Read(), for a process that keeps files for a long time: a mapping
+// faults (SIGBUS) if the file is truncated while it is being read, and a copy cannot.
+//
+// A large mapped file can be lexed ahead, all at once and in parallel, with LexAhead() before
+// its first line is read.  ReadLine() is unchanged, and Tokens() then gives the tokens of the
+// line it returned, so the Parser has no lexing left to do.
+//
+// Or it can be handed to a LinePipe with Pipeline(), again before its first line is read, which
+// reads and lexes it on threads of its own a few batches of lines ahead of the Parser.  ReadLine()
+// and IsEOF() then take their lines from the pipe, and Tokens() gives their tokens the same way.
+//
 //    Date     PGMR  Tracker  Description
 // ----------  ----  -------  -------------------------------------------------------------------
 // 2015-01-29  ADCL  Initial  This is the first version
@@ -13,6 +31,14 @@
 // 2015-02-09  ADCL   #261    Removed the EOFException from this file
 // 2015-02-09  ADCL   #258    Removed static members
 // 2015-02-09  ADCL   #257    Renamed this file to in-file.hpp
+// 2026-10-16  ADCL   U-001   Replaced the ifstream with a memory-mapped reader returning views
+// 2026-10-16  ADCL   U-007   Each InputFile registers its name and carries a FileId
+// 2026-10-16  ADCL   U-008   Split the mapping out into a shareable MappedFile
+// 2026-10-16  ADCL   U-023   A large file may be lexed ahead, on several threads (LexAhead())
+// 2026-10-16  ADCL   U-024   Or read and lexed by a pipeline, alongside the Parser (Pipeline())
+// 2026-10-16  ADCL   U-025   LexAhead() may be timed
+// 2026-10-16  ADCL   U-021   Added MappedFile::Read(), for contents kept in a buffer of their own
+// 2026-10-16  ADCL   U-021   The FileId is given by the FileStack, from its own registry
 //
 //===============================================================================================
 
@@ -20,36 +46,99 @@
 #define __IN_FILE_HPP__
 
 #ifndef __cplusplus
-#error The file 'parser.hpp' is not being compiled by a C++ compiler.
+#error The file 'in-file.hpp' is not being compiled by a C++ compiler.
 #endif
 
-#include <fstream>
+#include "lexer.hpp"
+#include "pipeline.hpp"
+#include "srcfile.hpp"
+#include "stats.hpp"
+
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// A MappedFile is the read-only contents of a file mapped into memory by Open(), or read into a
+// buffer by Read().  Both throw std::ios_base::failure if the file cannot be opened or read.
+//-----------------------------------------------------------------------------------------------
+class MappedFile
+{
+public:
+    static std::shared_ptr<const MappedFile> Open(const std::string &name);
+    static std::shared_ptr<const MappedFile> Read(const std::string &name);
+    virtual ~MappedFile();
+
+private:
+    MappedFile(void) : base(NULL), size(0) {};
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+public:
+    const char *Data(void) const { return base; };
+    size_t Size(void) const { return size; };
+
+private:
+    const char *base;
+    size_t size;
+    std::unique_ptr<char[]> copy;           // the contents, if they were read rather than mapped
+};
 
 //-----------------------------------------------------------------------------------------------
 // The InputFile class is responsbile for reading a line from a file and managing its location.
+//
+// The view returned by ReadLine() for a mapped file is valid as long as the MappedFile is (which
+// is at least as long as the InputFile).  For standard input, it is only valid until the next
+// call to ReadLine().  An empty name means stdin.
 //-----------------------------------------------------------------------------------------------
 class InputFile
 {
 public:
-    InputFile(const std::string &name);
-    virtual ~InputFile();
+    InputFile(const std::string &name, FileId id);
+    InputFile(const std::string &name, FileId id, std::shared_ptr<const MappedFile> contents);
+    virtual ~InputFile() {};
+
+private:
+    InputFile(const InputFile &);               // not copyable -- we own a read position
+    InputFile &operator=(const InputFile &);
 
 public:
-    std::string ReadLine(void);
+    std::string_view ReadLine(void);
+    void LexAhead(unsigned threads, Stats *stats = NULL);
+    void Pipeline(void);
+    bool Tokens(const Token *&first, size_t &count) const;
 
 public:
     std::string FileName(void) const { return fileName; };
+    const std::string &Path(void) const { return path; };
+    void SetPath(const std::string &p) { path = p; };
     long LineNum(void) const { return lineNum; };
-    bool IsEOF(void) const { return file->eof(); };
+    FileId FileNum(void) const { return fileNum; };
+    SrcLoc Location(void) const { return SrcLoc { fileNum, (uint32_t)lineNum }; };
+    bool IsEOF(void) { if (pipe) return pipe->AtEnd(); if (!mapped) Fill(); return pos >= size; };
     InputFile *Next(void) const { return next; };
     void SetNext(InputFile *n) { next = n; };
 
 private:
-    std::ifstream *file;
+    void Fill(void);
+
+private:
+    std::shared_ptr<const MappedFile> contents;
+    bool mapped;
+    bool inputEOF;
+    const char *base;                           // start of the mapping or of the stdin buffer
+    size_t size;                                // number of valid bytes at base
+    size_t pos;                                 // offset of the next unread line
+    std::vector<char> buffer;                   // only used for stdin
     InputFile *next;
     std::string fileName;
+    std::string path;                           // the canonical path, if the FileStack knows it
+    FileId fileNum;
     long lineNum;
+    std::unique_ptr<LexedText> lexed;           // every line's tokens, if the file was lexed ahead
+    std::unique_ptr<LinePipe> pipe;             // the lines and their tokens, if the file is piped
 };
 
 //===============================================================================================
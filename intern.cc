@@ -0,0 +1,86 @@
+//===============================================================================================
+// intern.cc -- This file contains the class implementation for the interned string pool.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+//
+//===============================================================================================
+
+#include "intern.hpp"
+#include "utils.hpp"
+
+#include <cstring>
+
+//-----------------------------------------------------------------------------------------------
+// StringPool::StringPool(Arena&) creates an empty pool holding only the empty string as id 0.
+//-----------------------------------------------------------------------------------------------
+StringPool::StringPool(Arena &a) : arena(a), strs(1, Entry { "", 0, 0 }), slots(64, Slot { 0, 0 })
+{
+}
+
+//-----------------------------------------------------------------------------------------------
+// StringPool::Find(std::string_view) returns the id of s, or 0 if it is not in the pool.
+//-----------------------------------------------------------------------------------------------
+uint32_t StringPool::Find(std::string_view s) const
+{
+    if (s.empty()) return 0;
+
+    uint32_t h = (uint32_t)HashBytes(s.data(), s.size());
+    size_t mask = slots.size() - 1;
+
+    for (size_t i = h & mask; slots[i].id; i = (i + 1) & mask) {
+        if (slots[i].hash == h && Str(slots[i].id) == s) return slots[i].id;
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+// StringPool::Intern(std::string_view) returns the id of s, adding it to the pool if needed.
+//-----------------------------------------------------------------------------------------------
+uint32_t StringPool::Intern(std::string_view s)
+{
+    if (s.empty()) return 0;
+
+    uint32_t h = (uint32_t)HashBytes(s.data(), s.size());
+    size_t mask = slots.size() - 1;
+    size_t i;
+
+    for (i = h & mask; slots[i].id; i = (i + 1) & mask) {
+        if (slots[i].hash == h && Str(slots[i].id) == s) return slots[i].id;
+    }
+
+    char *copy = static_cast<char *>(arena.Alloc(s.size() + 1, 1));
+    memcpy(copy, s.data(), s.size());
+    copy[s.size()] = '\0';
+
+    uint32_t id = (uint32_t)strs.size();
+    strs.push_back(Entry { copy, (uint32_t)s.size(), h });
+    slots[i] = Slot { id, h };
+
+    // -- keep the load factor under 1/2 so the probes stay short
+    if (strs.size() * 2 > slots.size()) Rehash();
+
+    return id;
+}
+
+//-----------------------------------------------------------------------------------------------
+// StringPool::Rehash() doubles the slot array.  The hash is kept in the Entry, so the strings
+// themselves are not touched.
+//-----------------------------------------------------------------------------------------------
+void StringPool::Rehash(void)
+{
+    std::vector<Slot> grown(slots.size() * 2, Slot { 0, 0 });
+    size_t mask = grown.size() - 1;
+
+    for (uint32_t id = 1; id < strs.size(); id ++) {
+        size_t i = strs[id].hash & mask;
+        while (grown[i].id) i = (i + 1) & mask;
+        grown[i] = Slot { id, strs[id].hash };
+    }
+
+    slots.swap(grown);
+}
+
+//===============================================================================================
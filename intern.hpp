@@ -0,0 +1,72 @@
+//===============================================================================================
+// intern.hpp -- This file contains the class definition for the interned string pool.
+//
+// Each distinct string is stored exactly once, in an Arena, and is thereafter referred to by a
+// small integer id.  Comparing 2 interned strings is then comparing 2 integers, and anything
+// that needs to keep a name (a symbol, a relocation, a string table) only keeps 4 bytes.  Id 0
+// is always the empty string, so it can be used to mean "no name".
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+//
+//===============================================================================================
+
+#ifndef __INTERN_HPP__
+#define __INTERN_HPP__
+
+#ifndef __cplusplus
+#error The file 'intern.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "arena.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The StringPool class.  The hash table is open addressing with linear probing; each slot keeps
+// the id and the hash so that a probe rarely has to touch the string itself.
+//-----------------------------------------------------------------------------------------------
+class StringPool {
+public:
+    StringPool(Arena &a);
+    virtual ~StringPool() {};
+
+private:
+    StringPool(const StringPool &);
+    StringPool &operator=(const StringPool &);
+
+public:
+    uint32_t Intern(std::string_view s);
+    uint32_t Find(std::string_view s) const;            // returns 0 if s was never interned
+    std::string_view Str(uint32_t id) const {
+        return std::string_view(strs[id].str, strs[id].len);
+    };
+    uint32_t Count(void) const { return (uint32_t)strs.size(); };
+
+private:
+    struct Entry {
+        const char *str;
+        uint32_t len;
+        uint32_t hash;
+    };
+
+    struct Slot {
+        uint32_t id;                                    // 0 means the slot is empty
+        uint32_t hash;
+    };
+
+private:
+    void Rehash(void);
+
+private:
+    Arena &arena;
+    std::vector<Entry> strs;
+    std::vector<Slot> slots;
+};
+
+//===============================================================================================
+
+#endif
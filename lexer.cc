@@ -0,0 +1,434 @@
+//===============================================================================================
+// lexer.cc -- This file contains the class implementation for breaking source text into tokens.
+//
+// This is the hot loop of the assembler, so it is written to touch each character once.  The
+// dispatch on the first character of a token is a single table lookup; identifiers of 8 or
+// fewer characters are packed (upper-cased) into a 64-bit key so that recognizing registers and
+// qualifiers is an integer compare rather than a string compare.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-023   Added LexLines(); Lex() grows the token array geometrically
+// 2026-10-16  ADCL   U-003   NumberValue() rejects a number too large for 64 bits
+//
+//===============================================================================================
+
+#include "lexer.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+//-----------------------------------------------------------------------------------------------
+// These are the actions the lexer takes based on the first character of a token.
+//-----------------------------------------------------------------------------------------------
+enum {
+    LX_ERROR,
+    LX_SPACE,
+    LX_EOL,
+    LX_IDENT,
+    LX_DIGIT,
+    LX_QUOTE,
+    LX_COMMENT,
+    LX_DOLLAR,
+    LX_SHIFT,
+    LX_PUNCT,
+};
+
+//-----------------------------------------------------------------------------------------------
+// LexTable maps every character to its action and, for single-character punctuation, to the
+// token type to emit.  It is built at compile time.
+//-----------------------------------------------------------------------------------------------
+struct LexTable {
+    uint8_t action[256];
+    TokenType punct[256];
+
+    constexpr LexTable(void) : action(), punct() {
+        for (int c = 0; c < 256; c ++) {
+            if (charClass.cls[c] & CC_SPACE) action[c] = LX_SPACE;
+            else if (charClass.cls[c] & CC_DIGIT) action[c] = LX_DIGIT;
+            else if (charClass.cls[c] & CC_ALPHA) action[c] = LX_IDENT;
+        }
+
+        action['\n'] = LX_EOL;
+        action['\''] = action['"'] = LX_QUOTE;
+        action[';'] = LX_COMMENT;
+        action['$'] = LX_DOLLAR;
+        action['<'] = action['>'] = LX_SHIFT;
+
+        SetPunct(',', TOK_COMMA);
+        SetPunct(':', TOK_COLON);
+        SetPunct('[', TOK_LBRACKET);
+        SetPunct(']', TOK_RBRACKET);
+        SetPunct('(', TOK_LPAREN);
+        SetPunct(')', TOK_RPAREN);
+        SetPunct('+', TOK_PLUS);
+        SetPunct('-', TOK_MINUS);
+        SetPunct('*', TOK_STAR);
+        SetPunct('/', TOK_SLASH);
+        SetPunct('%', TOK_PERCENT);
+        SetPunct('&', TOK_AMP);
+        SetPunct('|', TOK_PIPE);
+        SetPunct('^', TOK_CARET);
+        SetPunct('~', TOK_TILDE);
+    };
+
+    constexpr void SetPunct(unsigned char c, TokenType t) { action[c] = LX_PUNCT; punct[c] = t; };
+};
+
+static constexpr LexTable lexTable;
+
+//-----------------------------------------------------------------------------------------------
+// Key() packs up to 8 characters, upper-cased, into a 64-bit value.  The constexpr version is
+// used for the keywords; PackUpper() is the same thing for the source text.
+//-----------------------------------------------------------------------------------------------
+static constexpr uint64_t Key(const char *s)
+{
+    uint64_t k = 0;
+    for (int i = 0; s[i] && i < 8; i ++) k |= (uint64_t)(unsigned char)s[i] << (8 * i);
+    return k;
+}
+
+static inline uint64_t PackUpper(const char *s, size_t len)
+{
+    uint64_t k = 0;
+
+    for (size_t i = 0; i < len; i ++) {
+        unsigned char c = s[i];
+        if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        k |= (uint64_t)c << (8 * i);
+    }
+
+    return k;
+}
+
+//-----------------------------------------------------------------------------------------------
+// LookupRegister() returns the register id for a packed key, or R_NONE.
+//-----------------------------------------------------------------------------------------------
+static inline uint8_t LookupRegister(uint64_t k)
+{
+    switch (k) {
+    case Key("AL"): return R_AL;
+    case Key("CL"): return R_CL;
+    case Key("DL"): return R_DL;
+    case Key("BL"): return R_BL;
+    case Key("AH"): return R_AH;
+    case Key("CH"): return R_CH;
+    case Key("DH"): return R_DH;
+    case Key("BH"): return R_BH;
+    case Key("AX"): return R_AX;
+    case Key("CX"): return R_CX;
+    case Key("DX"): return R_DX;
+    case Key("BX"): return R_BX;
+    case Key("SP"): return R_SP;
+    case Key("BP"): return R_BP;
+    case Key("SI"): return R_SI;
+    case Key("DI"): return R_DI;
+    case Key("ES"): return R_ES;
+    case Key("CS"): return R_CS;
+    case Key("SS"): return R_SS;
+    case Key("DS"): return R_DS;
+    case Key("FS"): return R_FS;
+    case Key("GS"): return R_GS;
+    default: return R_NONE;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// LookupQualifier() returns the qualifier for a packed key, or 0.
+//-----------------------------------------------------------------------------------------------
+static inline uint8_t LookupQualifier(uint64_t k)
+{
+    switch (k) {
+    case Key("BYTE"): return Q_BYTE;
+    case Key("WORD"): return Q_WORD;
+    case Key("DWORD"): return Q_DWORD;
+    case Key("QWORD"): return Q_QWORD;
+    case Key("TWORD"): return Q_TWORD;
+    case Key("SHORT"): return Q_SHORT;
+    case Key("NEAR"): return Q_NEAR;
+    case Key("FAR"): return Q_FAR;
+    default: return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// SkipBlanks() skips spaces and tabs (but not the end of the line).
+//-----------------------------------------------------------------------------------------------
+static inline const char *SkipBlanks(const char *p, const char *end)
+{
+    while (p < end && *p != '\n' && IsSpace(*p)) p ++;
+    return p;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lexer::Lex(std::string_view, std::vector<Token>&) appends the tokens for text to tokens.  If
+// the text does not end in a newline, a final TOK_EOL is still emitted.
+//-----------------------------------------------------------------------------------------------
+void Lexer::Lex(std::string_view text, std::vector<Token> &tokens) const
+{
+    const char *base = text.data();
+    const char *end = base + text.size();
+    const char *p = base;
+    const char *lineStart = base;
+    bool haveMnemonic = false;
+
+    if (text.empty()) return;
+
+    // -- called a line at a time on one array, reserving just enough each time would be quadratic
+    if (tokens.capacity() - tokens.size() < text.size() / 4) {
+        tokens.reserve(std::max(tokens.capacity() * 2, tokens.size() + text.size() / 4));
+    }
+
+    auto emit = [&](TokenType t, const char *s, size_t len, uint8_t aux) {
+        tokens.push_back(Token { (uint32_t)(s - base), (uint16_t)(len > 0xffff ? 0xffff : len),
+                t, aux });
+    };
+
+    while (p < end) {
+        const char *s = p;
+        unsigned char c = *p ++;
+
+        switch (lexTable.action[c]) {
+        case LX_SPACE:
+            while (p < end && lexTable.action[(unsigned char)*p] == LX_SPACE) p ++;
+            break;
+
+        case LX_EOL:
+            emit(TOK_EOL, s, 1, 0);
+            lineStart = p;
+            haveMnemonic = false;
+            break;
+
+        case LX_COMMENT: {
+            const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+            p = (eol ? eol : end);
+            emit(TOK_COMMENT, s, p - s, 0);
+            break;
+        }
+
+        case LX_DIGIT:
+            while (p < end && IsClass(*p, CC_IDENT)) p ++;
+            emit(TOK_NUMBER, s, p - s, 0);
+            break;
+
+        case LX_QUOTE: {
+            while (p < end && *p != (char)c && *p != '\n') p ++;
+            if (p < end && *p == (char)c) emit(TOK_STRING, s, ++ p - s, 0);
+            else emit(TOK_ERROR, s, p - s, 0);
+            break;
+        }
+
+        case LX_DOLLAR:
+            if (p < end && *p == '$') p ++;
+            emit(TOK_DOLLAR, s, p - s, 0);
+            break;
+
+        case LX_SHIFT:
+            if (p < end && *p == (char)c) emit(c == '<' ? TOK_SHL : TOK_SHR, s, ++ p - s, 0);
+            else emit(TOK_ERROR, s, 1, 0);
+            break;
+
+        case LX_PUNCT:
+            emit(lexTable.punct[c], s, 1, 0);
+            break;
+
+        case LX_IDENT: {
+            while (p < end && IsClass(*p, CC_IDENT)) p ++;
+            size_t len = p - s;
+
+            // -- a label must start in the first position and be followed by a colon
+            if (s == lineStart && p < end && *p == ':') {
+                emit(TOK_LABEL, s, len, 0);
+                p ++;
+                break;
+            }
+
+            uint64_t k = (len <= 8 ? PackUpper(s, len) : 0);
+            uint8_t aux;
+
+            if ((aux = LookupRegister(k)) != R_NONE) {
+                const char *q = SkipBlanks(p, end);
+
+                if (IsSegReg(aux) && q < end && *q == ':') {
+                    p = q + 1;
+                    emit(TOK_SEGMENT, s, p - s, aux);
+                } else emit(TOK_REGISTER, s, len, aux);
+            } else if ((aux = LookupQualifier(k)) != 0) {
+                // -- a size qualifier may be followed by PTR, which we fold into the same token
+                const char *q = SkipBlanks(p, end);
+
+                if (aux < Q_SHORT && end - q >= 3 && PackUpper(q, 3) == Key("PTR")
+                        && (end - q == 3 || !IsClass(q[3], CC_IDENT))) {
+                    p = q + 3;
+                }
+
+                emit(TOK_QUALIFIER, s, p - s, aux);
+            } else if (!haveMnemonic) {
+                emit(TOK_MNEMONIC, s, len, 0);
+                haveMnemonic = true;
+            } else emit(TOK_IDENT, s, len, 0);
+
+            break;
+        }
+
+        default:
+            emit(TOK_ERROR, s, 1, 0);
+            break;
+        }
+    }
+
+    if (tokens.empty() || tokens.back().type != TOK_EOL) emit(TOK_EOL, end, 0, 0);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lexer::LexLines(std::string_view, unsigned, LexedText&) lexes every line of text into out,
+// using up to threads threads.  There are a few chunks for each thread, so that one slow chunk
+// (long comments lex faster than dense code) does not hold the rest up, but none smaller than
+// MIN_CHUNK.  Each chunk is lexed a line at a time into its own array; then the arrays are
+// copied into place, also in parallel, with the line starts offset to match.
+//-----------------------------------------------------------------------------------------------
+void Lexer::LexLines(std::string_view text, unsigned threads, LexedText &out) const
+{
+    static const size_t MIN_CHUNK = 64 * 1024;
+    static const size_t CHUNKS_PER_THREAD = 4;
+
+    struct Chunk {
+        const char *start;
+        const char *end;
+        std::vector<Token> tokens;
+        std::vector<uint32_t> lines;
+        size_t firstToken;
+        size_t firstLine;
+    };
+
+    const char *base = text.data();
+    const char *end = base + text.size();
+    size_t count = std::max<size_t>(1, std::min<size_t>((size_t)threads * CHUNKS_PER_THREAD,
+            text.size() / MIN_CHUNK));
+    std::vector<Chunk> chunks(count);
+    std::vector<std::thread> pool;
+    std::atomic<size_t> next(0);
+
+    // -- each chunk ends just after a newline (or at the end)
+    for (size_t c = 0; c < count; c ++) {
+        const char *p = (c + 1 == count ? end : base + text.size() / count * (c + 1));
+        const char *eol;
+
+        chunks[c].start = (c ? chunks[c - 1].end : base);
+        if (p < chunks[c].start) p = chunks[c].start;
+        if (p < end && (eol = static_cast<const char *>(memchr(p, '\n', end - p)))) p = eol + 1;
+        else p = end;
+
+        chunks[c].end = p;
+    }
+
+    auto run = [&](const std::function<void (Chunk &)> &work) {
+        auto worker = [&]() {
+            size_t c;
+            while ((c = next ++) < count) work(chunks[c]);
+        };
+
+        next = 0;
+        for (unsigned t = 1; t < threads && t < count; t ++) pool.emplace_back(worker);
+        worker();
+        for (size_t t = 0; t < pool.size(); t ++) pool[t].join();
+        pool.clear();
+    };
+
+    run([this](Chunk &c) {
+        const char *p = c.start;
+
+        c.tokens.reserve((c.end - c.start) / 3);
+
+        while (p < c.end) {
+            c.lines.push_back((uint32_t)c.tokens.size());
+            Lex(TakeLine(p, c.end), c.tokens);
+        }
+    });
+
+    size_t tokenCount = 0;
+    size_t lineCount = 0;
+
+    for (size_t c = 0; c < count; c ++) {
+        chunks[c].firstToken = tokenCount;
+        chunks[c].firstLine = lineCount;
+        tokenCount += chunks[c].tokens.size();
+        lineCount += chunks[c].lines.size();
+    }
+
+    out.tokens.reset(new Token[tokenCount]);
+    out.lines.reset(new uint32_t[lineCount + 1]);
+    out.lineCount = lineCount;
+    out.lines[lineCount] = (uint32_t)tokenCount;
+
+    run([&out](Chunk &c) {
+        if (!c.tokens.empty()) {
+            memcpy(&out.tokens[c.firstToken], c.tokens.data(), c.tokens.size() * sizeof(Token));
+        }
+
+        for (size_t i = 0; i < c.lines.size(); i ++) {
+            out.lines[c.firstLine + i] = (uint32_t)(c.firstToken + c.lines[i]);
+        }
+
+        std::vector<Token>().swap(c.tokens);
+        std::vector<uint32_t>().swap(c.lines);
+    });
+}
+
+//-----------------------------------------------------------------------------------------------
+// Lexer::NumberValue(std::string_view, int64_t&) converts the text of a TOK_NUMBER to its value.
+// The supported forms are: decimal (`123`), hex (`0x7c00` or `7c00h`), binary (`0b1010` or
+// `1010b`), and octal (`777o` or `777q`).  It returns false if the text is not a valid number,
+// or if its value does not fit in 64 bits.
+//-----------------------------------------------------------------------------------------------
+bool Lexer::NumberValue(std::string_view num, int64_t &value)
+{
+    unsigned radix = 10;
+    uint64_t v = 0;
+
+    if (num.empty()) return false;
+
+    if (num.size() > 2 && num[0] == '0' && (num[1] == 'x' || num[1] == 'X')) {
+        radix = 16;
+        num.remove_prefix(2);
+    } else if (num.size() > 2 && num[0] == '0' && (num[1] == 'b' || num[1] == 'B')
+            && num.find_first_not_of("01", 2) == std::string_view::npos) {
+        radix = 2;
+        num.remove_prefix(2);
+    } else {
+        switch (num.back()) {
+        case 'h': case 'H': radix = 16; num.remove_suffix(1); break;
+        case 'b': case 'B': case 'y': case 'Y': radix = 2; num.remove_suffix(1); break;
+        case 'o': case 'O': case 'q': case 'Q': radix = 8; num.remove_suffix(1); break;
+        default: break;
+        }
+    }
+
+    if (num.empty()) return false;
+
+    for (size_t i = 0; i < num.size(); i ++) {
+        unsigned char c = num[i];
+        unsigned d;
+
+        if (c == '_') continue;
+        else if (c >= '0' && c <= '9') d = c - '0';
+        else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+        else return false;
+
+        if (d >= radix) return false;
+        if (v > (UINT64_MAX - d) / radix) return false;
+        v = v * radix + d;
+    }
+
+    value = (int64_t)v;
+    return true;
+}
+
+//===============================================================================================
@@ -0,0 +1,150 @@
+//===============================================================================================
+// lexer.hpp -- This file contains the class definition for breaking source text into tokens.
+//
+// The lexer makes exactly one pass over its input.  Each character is classified through a
+// 256-entry table and the resulting tokens are recorded as an offset and length into the source
+// text -- no part of the source is ever copied.  The input may be a single line or a whole
+// buffer of lines; the end of every line is marked with a TOK_EOL token.
+//
+// Identifiers are further classified so that the parser does not have to look at them again:
+// * An identifier in the first position of a line followed by a ':' is a TOK_LABEL (the token
+//   covers the name only; the colon is consumed).
+// * The first other identifier on a line is the TOK_MNEMONIC (an opcode or a directive).
+// * Registers are TOK_REGISTER and segment overrides (`CS:`) are TOK_SEGMENT; aux holds the
+//   register id.
+// * Size and distance qualifiers (`BYTE PTR`, `WORD`, `SHORT`, ...) are TOK_QUALIFIER; aux holds
+//   the qualifier.  `BYTE PTR` is a single token covering both words.
+//
+// Nothing about a line depends on the lines before it, so a whole file can also be lexed ahead
+// of the parser, in pieces: LexLines() splits the text into chunks on line boundaries, lexes
+// the chunks on several threads, each line by itself into the chunk's own token array, and then
+// joins the arrays in order.  The result is exactly what lexing the lines one at a time gives.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-023   Added LexLines(), which lexes a whole file on several threads
+//
+//===============================================================================================
+
+#ifndef __LEXER_HPP__
+#define __LEXER_HPP__
+
+#ifndef __cplusplus
+#error The file 'lexer.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// These are the token types.
+//-----------------------------------------------------------------------------------------------
+typedef enum : uint8_t {
+    TOK_EOL,
+    TOK_LABEL,
+    TOK_MNEMONIC,
+    TOK_IDENT,
+    TOK_REGISTER,
+    TOK_SEGMENT,
+    TOK_QUALIFIER,
+    TOK_NUMBER,
+    TOK_STRING,
+    TOK_DOLLAR,
+    TOK_COMMA,
+    TOK_COLON,
+    TOK_LBRACKET,
+    TOK_RBRACKET,
+    TOK_LPAREN,
+    TOK_RPAREN,
+    TOK_PLUS,
+    TOK_MINUS,
+    TOK_STAR,
+    TOK_SLASH,
+    TOK_PERCENT,
+    TOK_AMP,
+    TOK_PIPE,
+    TOK_CARET,
+    TOK_TILDE,
+    TOK_SHL,
+    TOK_SHR,
+    TOK_COMMENT,
+    TOK_ERROR,
+} TokenType;
+
+//-----------------------------------------------------------------------------------------------
+// The register ids are ordered so that the low 3 bits are the register's encoding in a ModR/M
+// byte.  The register class is then simply the range the id falls in.
+//-----------------------------------------------------------------------------------------------
+typedef enum : uint8_t {
+    R_AL, R_CL, R_DL, R_BL, R_AH, R_CH, R_DH, R_BH,
+    R_AX, R_CX, R_DX, R_BX, R_SP, R_BP, R_SI, R_DI,
+    R_ES, R_CS, R_SS, R_DS, R_FS, R_GS,
+    R_NONE = 0xff,
+} RegisterId;
+
+inline bool IsReg8(uint8_t r) { return r <= R_BH; }
+inline bool IsReg16(uint8_t r) { return r >= R_AX && r <= R_DI; }
+inline bool IsSegReg(uint8_t r) { return r >= R_ES && r <= R_GS; }
+inline uint8_t RegCode(uint8_t r) { return r & 0x07; }
+
+//-----------------------------------------------------------------------------------------------
+// These are the qualifiers.  The sizes are the operand size in bytes.
+//-----------------------------------------------------------------------------------------------
+typedef enum : uint8_t {
+    Q_BYTE = 1,
+    Q_WORD = 2,
+    Q_DWORD = 4,
+    Q_QWORD = 8,
+    Q_TWORD = 10,
+    Q_SHORT = 0x81,
+    Q_NEAR = 0x82,
+    Q_FAR = 0x83,
+} Qualifier;
+
+//-----------------------------------------------------------------------------------------------
+// A Token is 8 bytes.  offset and length locate the token in the text given to the lexer.
+//-----------------------------------------------------------------------------------------------
+struct Token {
+    uint32_t offset;
+    uint16_t length;
+    TokenType type;
+    uint8_t aux;                    // register id or qualifier; otherwise 0
+};
+
+//-----------------------------------------------------------------------------------------------
+// A LexedText is a buffer of lines lexed by LexLines().  The tokens of line i (counting from 0)
+// are tokens[lines[i]] up to tokens[lines[i + 1]], with their offsets from the start of that
+// line, as Lex() gives them for the line alone.
+//-----------------------------------------------------------------------------------------------
+struct LexedText {
+    std::unique_ptr<Token[]> tokens;
+    std::unique_ptr<uint32_t[]> lines;      // lineCount + 1 entries
+    size_t lineCount;
+};
+
+//-----------------------------------------------------------------------------------------------
+// The Lexer class holds no state between calls; it is a class so that it can grow options
+// (such as a different comment character) without changing every caller.
+//-----------------------------------------------------------------------------------------------
+class Lexer {
+public:
+    Lexer(void) {};
+    virtual ~Lexer() {};
+
+public:
+    void Lex(std::string_view text, std::vector<Token> &tokens) const;
+    void LexLines(std::string_view text, unsigned threads, LexedText &out) const;
+
+public:
+    static std::string_view Text(std::string_view text, const Token &t)
+            { return text.substr(t.offset, t.length); };
+    static bool NumberValue(std::string_view num, int64_t &value);
+};
+
+//===============================================================================================
+
+#endif
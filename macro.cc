@@ -0,0 +1,230 @@
+//===============================================================================================
+// macro.cc -- This file contains the class implementation for macros.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-018   Initial version
+//
+//===============================================================================================
+
+#include "macro.hpp"
+
+#include <cstdio>
+
+//-----------------------------------------------------------------------------------------------
+// SameName() compares 2 names without regard to case, as the SymbolTable does.
+//-----------------------------------------------------------------------------------------------
+static bool SameName(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size()) return false;
+
+    for (size_t i = 0; i < a.size(); i ++) {
+        unsigned char x = a[i], y = b[i];
+
+        if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+        if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+        if (x != y) return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// MacroTable::Begin(SrcLoc) starts the definition of a macro and returns its index.
+//-----------------------------------------------------------------------------------------------
+uint32_t MacroTable::Begin(SrcLoc loc)
+{
+    defining = true;
+    names.clear();
+    macros.push_back(Macro { (uint32_t)lines.size(), 0, 0, 0, loc });
+
+    return (uint32_t)(macros.size() - 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// MacroTable::AddParam(std::string_view) and MacroTable::AddLocal(std::string_view) add a name
+// to the macro being defined.  The parameters all come first.
+//-----------------------------------------------------------------------------------------------
+bool MacroTable::AddParam(std::string_view name)
+{
+    for (size_t i = 0; i < names.size(); i ++) if (SameName(names[i], name)) return false;
+
+    names.emplace_back(name);
+    macros.back().params ++;
+    return true;
+}
+
+bool MacroTable::AddLocal(std::string_view name)
+{
+    for (size_t i = 0; i < names.size(); i ++) if (SameName(names[i], name)) return false;
+
+    names.emplace_back(name);
+    macros.back().locals ++;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// MacroTable::AddLine(std::string_view, const std::vector<Token>&) adds a line, already lexed, to
+// the body of the macro being defined.
+//-----------------------------------------------------------------------------------------------
+void MacroTable::AddLine(std::string_view line, const std::vector<Token> &lineTokens)
+{
+    uint32_t base = (uint32_t)text.size();
+    Line l { (uint32_t)tokens.size(), 0, (uint32_t)refs.size(), 0 };
+
+    text.append(line);
+
+    for (size_t i = 0; i < lineTokens.size(); i ++) {
+        Token t = lineTokens[i];
+
+        if (t.type == TOK_COMMENT) continue;
+
+        if (t.type == TOK_IDENT || t.type == TOK_MNEMONIC || t.type == TOK_LABEL) {
+            std::string_view s = Lexer::Text(line, t);
+
+            for (size_t k = 0; k < names.size(); k ++) {
+                if (!SameName(names[k], s)) continue;
+
+                refs.push_back(Ref { l.tokenCount, (uint32_t)k });
+                l.refCount ++;
+                break;
+            }
+        }
+
+        t.offset += base;
+        tokens.push_back(t);
+        l.tokenCount ++;
+    }
+
+    lines.push_back(l);
+    macros.back().lineCount ++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// MacroTable::End() ends the definition.
+//-----------------------------------------------------------------------------------------------
+void MacroTable::End(void)
+{
+    defining = false;
+    names.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// MacroTable::Expand(...) starts an expansion of a macro, with the arguments in the tokens
+// [first..last) of a line.  The arguments are split at the commas that are not inside
+// parentheses or brackets; an argument that is not given is empty.
+//-----------------------------------------------------------------------------------------------
+bool MacroTable::Expand(uint32_t macro, std::string_view line, const std::vector<Token> &lineTokens,
+        size_t first, size_t last, std::string &why)
+{
+    const Macro &m = macros[macro];
+    Frame f { macro, m.firstLine, (uint32_t)ranges.size(), (uint32_t)args.size(),
+            (uint32_t)text.size() };
+    bool copy = (line.data() != text.data());       // the line is not itself from an expansion
+    uint32_t n = 0;
+    int depth = 0;
+
+    if (frames.size() == MAX_DEPTH) {
+        why = "macros are nested too deeply";
+        return false;
+    }
+
+    for (size_t i = first, start = first; i <= last && first < last; i ++) {
+        if (i < last) {
+            TokenType t = lineTokens[i].type;
+
+            if (t == TOK_LPAREN || t == TOK_LBRACKET) depth ++;
+            if (t == TOK_RPAREN || t == TOK_RBRACKET) depth --;
+            if (t != TOK_COMMA || depth > 0) continue;
+        }
+
+        if (n ++ == m.params) {
+            why = "too many arguments for the macro";
+            text.resize(f.textMark);
+            args.resize(f.args);
+            ranges.resize(f.ranges);
+            return false;
+        }
+
+        ranges.push_back(Range { (uint32_t)args.size(), (uint32_t)(i - start) });
+
+        if (copy && i > start) {
+            uint32_t from = lineTokens[start].offset;
+            uint32_t to = lineTokens[i - 1].offset + lineTokens[i - 1].length;
+            uint32_t at = (uint32_t)text.size();
+
+            text.append(line.substr(from, to - from));
+
+            for (size_t k = start; k < i; k ++) {
+                Token t = lineTokens[k];
+                t.offset = t.offset - from + at;
+                args.push_back(t);
+            }
+        } else args.insert(args.end(), lineTokens.begin() + start, lineTokens.begin() + i);
+
+        start = i + 1;
+    }
+
+    for ( ; n < m.params; n ++) ranges.push_back(Range { (uint32_t)args.size(), 0 });
+
+    // -- a fresh name for each local
+    for (uint32_t k = 0; k < m.locals; k ++) {
+        char name[16];
+        int len = snprintf(name, sizeof(name), "??%04u", ++ nextLocal);
+
+        ranges.push_back(Range { (uint32_t)args.size(), 1 });
+        args.push_back(Token { (uint32_t)text.size(), (uint16_t)len, TOK_IDENT, 0 });
+        text.append(name, len);
+    }
+
+    frames.push_back(f);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// MacroTable::Next(std::vector<Token>&) replaces the contents of out with the tokens of the next
+// line of the innermost expansion, ending any expansions that are done.  It returns false when
+// there are no more.  The tokens index into Text().
+//-----------------------------------------------------------------------------------------------
+bool MacroTable::Next(std::vector<Token> &out)
+{
+    while (!frames.empty()) {
+        Frame &f = frames.back();
+        const Macro &m = macros[f.macro];
+
+        if (f.line == m.firstLine + m.lineCount) {
+            text.resize(f.textMark);
+            args.resize(f.args);
+            ranges.resize(f.ranges);
+            frames.pop_back();
+            continue;
+        }
+
+        const Line &l = lines[f.line ++];
+        const Token *body = tokens.data() + l.firstToken;
+        uint32_t at = 0;
+
+        out.clear();
+
+        for (uint32_t r = l.firstRef; r < l.firstRef + l.refCount; r ++) {
+            const Ref &ref = refs[r];
+            const Range &a = ranges[f.ranges + ref.arg];
+
+            out.insert(out.end(), body + at, body + ref.token);
+            size_t k = out.size();
+            out.insert(out.end(), args.begin() + a.first, args.begin() + a.first + a.count);
+
+            // -- a label or an opcode that is a parameter keeps its place in the line
+            if (a.count == 1 && out[k].type == TOK_IDENT) out[k].type = body[ref.token].type;
+
+            at = ref.token + 1;
+        }
+
+        out.insert(out.end(), body + at, body + l.tokenCount);
+        return true;
+    }
+
+    return false;
+}
+
+//===============================================================================================
@@ -0,0 +1,137 @@
+//===============================================================================================
+// macro.hpp -- This file contains the class definition for macros.
+//
+// A macro is defined with:
+//
+//     name MACRO [param [, param]...]
+//          LOCAL label [, label]...
+//          ...
+//          ENDM
+//
+// and is expanded wherever its name is used as an opcode, with its arguments separated by
+// commas.  The LOCAL labels are given a fresh name (`??0001`, ...) in each expansion, so a macro
+// may be expanded many times and still have labels of its own.
+//
+// The lines of a macro are lexed exactly once, when the macro is defined: their text is copied
+// into the table's text store and their tokens (less any comment) are kept with the offsets
+// moved to match.  Each use of a parameter or LOCAL in the body is recorded as a Ref, the token
+// to replace and the argument that replaces it.  Expanding a line is then only a copy of its
+// tokens into the Parser's token buffer, with the argument tokens spliced in at the Refs --
+// there is no text to rebuild and nothing to lex again.
+//
+// All the tokens handed to the Parser must index into a single text, so the arguments of an
+// expansion live in the same text store, above the bodies.  For a macro used in the source the
+// text of the arguments is copied there once, when the expansion starts; for a macro used inside
+// another one it is there already.  Expansions nest, and end in the reverse of the order they
+// start, so the argument text and tokens are kept as a stack and dropped as each expansion ends.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-018   Initial version
+//
+//===============================================================================================
+
+#ifndef __MACRO_HPP__
+#define __MACRO_HPP__
+
+#ifndef __cplusplus
+#error The file 'macro.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "lexer.hpp"
+#include "srcfile.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The MacroTable class.  The Parser owns one; the names of the macros are in the Parser's
+// SymbolTable (SYM_MACRO, with the value being the macro's index here).
+//
+// To define a macro, the Parser calls Begin() and AddParam() for each parameter, then AddLocal()
+// and AddLine() for the lines of the body, and End() at the ENDM.  AddParam() and AddLocal()
+// return false for a name that is already a parameter or local.  To expand a macro, the Parser
+// calls Expand() and then takes lines from Next() until it returns false.  Expand() returns
+// false (with the reason in why) if the macro cannot be expanded.
+//-----------------------------------------------------------------------------------------------
+class MacroTable {
+public:
+    static const size_t MAX_DEPTH = 64;     // how deeply expansions may nest
+
+public:
+    MacroTable(void) : defining(false), nextLocal(0) {};
+    virtual ~MacroTable() {};
+
+private:
+    MacroTable(const MacroTable &);
+    MacroTable &operator=(const MacroTable &);
+
+public:
+    uint32_t Begin(SrcLoc loc);
+    bool AddParam(std::string_view name);
+    bool AddLocal(std::string_view name);
+    void AddLine(std::string_view line, const std::vector<Token> &tokens);
+    void End(void);
+    bool Defining(void) const { return defining; };
+    bool HasBody(void) const { return macros.back().lineCount != 0; };
+    SrcLoc Location(void) const { return macros.back().loc; };
+
+    bool Expand(uint32_t macro, std::string_view line, const std::vector<Token> &tokens,
+            size_t first, size_t last, std::string &why);
+    bool Next(std::vector<Token> &out);
+    bool Expanding(void) const { return !frames.empty(); };
+    std::string_view Text(void) const { return text; };
+
+private:
+    struct Macro {
+        uint32_t firstLine;         // the index of the first Line
+        uint32_t lineCount;
+        uint32_t params;            // the parameters, then the locals, are numbered from 0
+        uint32_t locals;
+        SrcLoc loc;
+    };
+
+    struct Line {
+        uint32_t firstToken;
+        uint32_t tokenCount;
+        uint32_t firstRef;
+        uint32_t refCount;
+    };
+
+    struct Ref {
+        uint32_t token;             // the index of the token within its Line
+        uint32_t arg;
+    };
+
+    struct Range {
+        uint32_t first;             // the index of the first token in args
+        uint32_t count;
+    };
+
+    struct Frame {
+        uint32_t macro;
+        uint32_t line;              // the next Line to expand
+        uint32_t ranges;            // the index of the Range for argument 0
+        uint32_t args;              // where the argument tokens start, to drop them at the end
+        uint32_t textMark;          // where the argument text starts, likewise
+    };
+
+private:
+    bool defining;
+    std::vector<std::string> names;         // the parameters and locals of the macro being defined
+    std::vector<Macro> macros;
+    std::vector<Line> lines;
+    std::vector<Token> tokens;
+    std::vector<Ref> refs;
+    std::string text;                       // the bodies, then the arguments of the expansions
+    std::vector<Frame> frames;
+    std::vector<Range> ranges;
+    std::vector<Token> args;
+    uint32_t nextLocal;
+};
+
+//===============================================================================================
+
+#endif
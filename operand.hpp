@@ -0,0 +1,75 @@
+//===============================================================================================
+// operand.hpp -- This file contains the definition of a parsed instruction operand.
+//
+// The Parser turns the tokens of each operand into an Operand.  The most important part of an
+// Operand is its class (an OperandClass from OpCodeTable.h): the classes of all the operands of
+// an instruction are packed into a signature and that signature picks the OpCodeTable rows
+// that can encode the instruction.  The rest of the Operand is what the encoder needs to build
+// the bytes -- the register, the memory addressing registers, and the value.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-010   Initial version
+// 2026-10-16  ADCL   U-013   An operand refers to its Symbol rather than naming it
+// 2026-10-16  ADCL   U-017   An operand may hold an expression that could not be folded
+//
+//===============================================================================================
+
+#ifndef __OPERAND_HPP__
+#define __OPERAND_HPP__
+
+#ifndef __cplusplus
+#error The file 'operand.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "OpCodeTable.h"
+#include "lexer.hpp"
+
+#include <cstdint>
+
+class Symbol;
+
+//-----------------------------------------------------------------------------------------------
+// An Operand.  For a memory operand, base is R_BX or R_BP and index is R_SI or R_DI (either may
+// be R_NONE) and value is the displacement.  For an immediate, value is the value; for a FAR
+// immediate (`seg:off`) value is the offset and segment the segment.  When the value depends on
+// where a label ends up, sym is the label (or here is set, for `$`) and value holds only the
+// constant part; the Relaxer fills in the rest.  Any other expression that depends on a label
+// is kept as expr, a node in the Parser's ExprPool, and value is 0.
+//-----------------------------------------------------------------------------------------------
+struct Operand {
+    uint8_t cls;                    // the OperandClass
+    uint8_t reg;                    // the register for a register operand; else R_NONE
+    uint8_t seg;                    // a segment override for a memory operand; else R_NONE
+    uint8_t base;
+    uint8_t index;
+    uint8_t qual;                   // the qualifier written (BYTE, SHORT, ...) or 0
+    uint16_t segment;
+    bool here;                      // the value is relative to the start of the instruction
+    int64_t value;
+    Symbol *sym;
+    uint32_t expr;
+
+    Operand(void) : cls(OC_NONE), reg(R_NONE), seg(R_NONE), base(R_NONE), index(R_NONE), qual(0),
+            segment(0), here(false), value(0), sym(NULL), expr(0) {};
+
+    bool IsMemory(void) const { return cls >= OC_MEM && cls <= OC_MOFFS16; };
+    bool IsImmediate(void) const { return cls >= OC_ONE && cls <= OC_FAR; };
+    bool IsUnsized(void) const { return cls == OC_MEM || cls == OC_MOFFS; };
+    bool IsRelocatable(void) const { return sym != NULL || here || expr; };
+};
+
+//-----------------------------------------------------------------------------------------------
+// ImmediateClass() returns the class of an immediate value: the smallest range it fits in.
+//-----------------------------------------------------------------------------------------------
+inline uint8_t ImmediateClass(int64_t v)
+{
+    if (v == 1) return OC_ONE;
+    if (v >= -128 && v <= 127) return OC_IMM8S;
+    if (v >= 128 && v <= 255) return OC_IMM8;
+    return OC_IMM16;
+}
+
+//===============================================================================================
+
+#endif
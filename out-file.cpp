@@ -0,0 +1,108 @@
+//===============================================================================================
+// out-file.cpp -- This file contains the class implementation for writing output files.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-015   Initial version (split out of the ELF writer)
+// 2026-10-16  ADCL   U-019   Replace the file rather than write through it
+// 2026-10-16  ADCL   U-014   Allocate the file's blocks; write a temporary file and Commit() it
+//
+//===============================================================================================
+
+#include "out-file.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <ios>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//-----------------------------------------------------------------------------------------------
+// TempName() is a name for a temporary file beside path, unique to this process and call (the
+// server writes from several threads at once).
+//-----------------------------------------------------------------------------------------------
+static std::string TempName(const std::string &path)
+{
+    static std::atomic<unsigned> count(0);
+
+    return path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(count ++);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Error() is the error code for err, so that the failure says why (a full disk, most often).
+//-----------------------------------------------------------------------------------------------
+static std::error_code Error(int err)
+{
+    return std::error_code(err, std::generic_category());
+}
+
+//-----------------------------------------------------------------------------------------------
+// OutputFile::OutputFile(const std::string&, size_t) creates a temporary file for path, with n
+// bytes allocated, and maps it.  An empty file has nothing to allocate or map.
+//-----------------------------------------------------------------------------------------------
+OutputFile::OutputFile(const std::string &p, size_t n)
+        : path(p), tmp(TempName(p)), base(NULL), size(n)
+{
+    int fd = open(tmp.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (fd < 0) throw std::ios_base::failure("Unable to create file " + path, Error(errno));
+
+    if (size) {
+        // -- posix_fallocate() returns the error rather than setting errno
+        int err = posix_fallocate(fd, 0, size);
+
+        if (err) {
+            close(fd);
+            unlink(tmp.c_str());
+            throw std::ios_base::failure("Unable to allocate file " + path, Error(err));
+        }
+
+        void *m = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        if (m == MAP_FAILED) {
+            close(fd);
+            unlink(tmp.c_str());
+            throw std::ios_base::failure("Unable to map file " + path);
+        }
+
+        base = static_cast<uint8_t *>(m);
+    }
+
+    // -- the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+//-----------------------------------------------------------------------------------------------
+// OutputFile::Commit() releases the mapping, which leaves the contents in the temporary file,
+// and renames it to path.  Renaming replaces any old file rather than writing through it, since
+// that may be a hard link into the assembly cache.
+//-----------------------------------------------------------------------------------------------
+void OutputFile::Commit(void)
+{
+    if (base) munmap(base, size);
+    base = NULL;
+
+    if (rename(tmp.c_str(), path.c_str()) < 0) {
+        int err = errno;
+
+        unlink(tmp.c_str());
+        tmp.clear();
+        throw std::ios_base::failure("Unable to create file " + path, Error(err));
+    }
+
+    tmp.clear();
+}
+
+//-----------------------------------------------------------------------------------------------
+// OutputFile::~OutputFile() releases the mapping, and removes the temporary file if it was never
+// committed.
+//-----------------------------------------------------------------------------------------------
+OutputFile::~OutputFile()
+{
+    if (base) munmap(base, size);
+    if (!tmp.empty()) unlink(tmp.c_str());
+}
+
+//===============================================================================================
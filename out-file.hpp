@@ -0,0 +1,62 @@
+//===============================================================================================
+// out-file.hpp -- This file contains the class definition for writing output files.
+//
+// Every output format knows the size of its file before it writes a byte of it, so an output
+// file is created at its final size and mapped into memory, and the writer puts each part
+// straight into place.  There is no buffer between the writer and the file, and the padding
+// between the parts is already 0 since the file was extended with posix_fallocate().
+//
+// The blocks are allocated up front, rather than left sparse, so that a full disk is an error
+// from the constructor and not a SIGBUS from the first store into a page with nowhere to go.
+// The file is written under a temporary name in the same directory and only renamed to its path
+// by Commit(), once the writer has finished with it; an OutputFile destroyed without being
+// committed (the writer threw) removes its temporary file, so a failed assembly never leaves a
+// partial object behind under the name of a good one.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-015   Initial version (split out of the ELF writer)
+// 2026-10-16  ADCL   U-014   Allocate the file's blocks; write a temporary file and Commit() it
+//
+//===============================================================================================
+
+#ifndef __OUT_FILE_HPP__
+#define __OUT_FILE_HPP__
+
+#ifndef __cplusplus
+#error The file 'out-file.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// The OutputFile class.  The constructor throws std::ios_base::failure if the file cannot be
+// created, allocated, or mapped, and Commit() if it cannot be put in place.
+//-----------------------------------------------------------------------------------------------
+class OutputFile
+{
+public:
+    OutputFile(const std::string &path, size_t n);
+    virtual ~OutputFile();
+
+private:
+    OutputFile(const OutputFile &);
+    OutputFile &operator=(const OutputFile &);
+
+public:
+    template <typename T> T *At(size_t off) { return reinterpret_cast<T *>(base + off); };
+    size_t Size(void) const { return size; };
+    void Commit(void);
+
+private:
+    std::string path;
+    std::string tmp;
+    uint8_t *base;
+    size_t size;
+};
+
+//===============================================================================================
+
+#endif
@@ -9,66 +9,1126 @@
 //    Date     PGMR  Tracker  Description
 // ----------  ----  -------  -------------------------------------------------------------------
 // 2015-01-30  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-002   ParseLine() works on string_view and no longer needs a try block
+// 2026-10-16  ADCL   U-003   ParseLine() is now driven by the single-pass Lexer
+// 2026-10-16  ADCL   U-005   Look up the opcode through the SIMD-folded perfect hash
+// 2026-10-16  ADCL   U-008   Added the constructor, Parse(), and the INCLUDE/ONCE directives
+// 2026-10-16  ADCL   U-009   Errors go to the Parser's own diagnostic stream
+// 2026-10-16  ADCL   U-010   Added the operand parser and the match against the OpCodeTable rows
+// 2026-10-16  ADCL   U-011   Added the CPU and BITS directives, which select the active OpCodeView
+// 2026-10-16  ADCL   U-012   Labels are defined and instructions are encoded into the code Section
+// 2026-10-16  ADCL   U-013   Branches start short and are relaxed; labels may be forward references
+// 2026-10-16  ADCL   U-015   Added the ORG directive
+// 2026-10-16  ADCL   U-016   Undefined symbols may be left as externals
+// 2026-10-16  ADCL   U-017   Operand expressions are parsed by precedence and folded; added EQU
+// 2026-10-16  ADCL   U-018   Added MACRO/ENDM/LOCAL; lines are taken from an expansion first
+// 2026-10-16  ADCL   U-021   The constructor takes the directory relative file names are from
+// 2026-10-16  ADCL   U-023   A line from a file that was lexed ahead comes with its tokens
+// 2026-10-16  ADCL   U-025   Count the tokens and candidate rows; time the parse and relaxation
+// 2026-10-16  ADCL   U-008   INCLUDE with an empty file name is an error
+// 2026-10-16  ADCL   U-021   File names come from the FileStack's own registry
+// 2026-10-16  ADCL   U-025   Count into the Stats as we go, and only if there are Stats
 //
 //===============================================================================================
 
 #include "parser.hpp"
+#include "encoder.hpp"
 #include "utils.hpp"
 #include <iostream>
+#include <new>
+#include <stdexcept>
 
 //-----------------------------------------------------------------------------------------------
-// Parser::ParseLine(std::string) is likely to be one of the most complicated functions in the
-// assembler.  It is responsible for parsing out a line into one of its 6 possible components.
+// Parser::Parser(const std::string&, std::ostream&, const std::string&) opens the top-level file;
+// relative names (this one and any included) are from dir, or the current directory if it is
+// empty.  If the file cannot be opened, the std::ios_base::failure from the FileStack is passed
+// on to the caller.
 //-----------------------------------------------------------------------------------------------
-void Parser::ParseLine(std::string line)
+Parser::Parser(const std::string &f, std::ostream &d, const std::string &dir) : diag(d), errors(0),
+        opFirst(0), opLast(0), opRows(NULL), opRowCount(0), opCount(0), matches(NULL),
+        matchCount(0), isa(0), view(NULL), code(".text"), origin(0), externals(false),
+        relaxer(exprs), stats(NULL)
 {
-#if 0
+    SelectIsa(ISA_DEFAULT);
+    fStack.SetDirectory(dir);
+    fStack.Push(f);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Parse() reads every line from the file stack (including any files that are included
+// along the way, and the lines of any macros expanded) and parses it.  This is the only pass
+// over the source: once every line is in, the Relaxer settles the branches, gives the labels
+// their final addresses, and resolves the references that were waiting for them.  With a Stats,
+// the two are timed, and the counts are added to it at the end.
+//-----------------------------------------------------------------------------------------------
+void Parser::Parse(void)
+{
+    StageTimer parse(stats, "parse");
+
+    while (NextLine()) {
+        if (macros.Defining()) {
+            Body();
+            continue;
+        }
+
+        // -- `name: EQU value` and `name EQU value` define name, not a label or an instruction
+        if (!label.empty() && !opCode.empty() && !opRows && LookupDirective(opCode) == DIR_EQU) {
+            Equ(label, opFirst);
+            continue;
+        }
+
+        if (!label.empty()) DefineLabel(label, code.Size());
+        if (opCode.empty()) continue;
+
+        if (opFirst < opLast && tokens[opFirst].type == TOK_IDENT) {
+            switch (LookupDirective(Lexer::Text(line, tokens[opFirst]))) {
+            case DIR_EQU:
+                Equ(opCode, opFirst + 1);
+                continue;
+
+            case DIR_MACRO:
+                Macro();
+                continue;
+
+            default:
+                break;
+            }
+        }
+
+        if (opRows) {
+            if (ParseOperands() && MatchOperands()) Emit();
+            continue;
+        }
+
+        switch (LookupDirective(opCode)) {
+        case DIR_CPU:
+            Cpu();
+            break;
+
+        case DIR_BITS:
+            Bits();
+            break;
+
+        case DIR_ORG:
+            Org();
+            break;
+
+        case DIR_INCLUDE:
+            Include();
+            break;
+
+        case DIR_ONCE:
+            fStack.MarkOnce();
+            break;
+
+        case DIR_EQU:
+            Error("EQU must follow the name it defines");
+            break;
+
+        case DIR_MACRO:
+            Error("MACRO must follow the name of the macro");
+            break;
+
+        case DIR_ENDM:
+            Error("ENDM without MACRO");
+            break;
+
+        case DIR_LOCAL:
+            Error("LOCAL is only valid in a macro");
+            break;
+
+        case DIR_NONE: {
+            const Symbol *sym = LookupSymbol(opCode);
+
+            if (sym && sym->GetType() == Symbol::SYM_MACRO) Expand(sym);
+            else Error("unknown instruction or directive '" + std::string(opCode) + "'");
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    if (macros.Defining()) ErrorAt(macros.Location(), "MACRO without ENDM");
+
+    parse.Stop();
+
+    StageTimer relax(stats, "relax");
+    relaxer.Finish(code, origin, externals, symTab,
+            [this](SrcLoc loc, const std::string &msg) { ErrorAt(loc, msg); });
+    relax.Stop();
+
+    if (stats) {
+        stats->branches += relaxer.Branches();
+        stats->grown += relaxer.Grown();
+        stats->visits += relaxer.Visits();
+        stats->bytes += code.Size();
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::LookupDirective(std::string_view) returns the directive named by op, if any.  The
+// names are compared the same way as the mnemonics -- as folded 16-byte keys.
+//-----------------------------------------------------------------------------------------------
+Parser::Directive Parser::LookupDirective(std::string_view op)
+{
+    static const struct {
+        const char *name;
+        Directive dir;
+    } names[] = {
+        {"CPU", DIR_CPU},
+        {"BITS", DIR_BITS},
+        {"MODEL", DIR_MODEL},
+        {"ORG", DIR_ORG},
+        {"EVEN", DIR_EVEN},
+        {"EQU", DIR_EQU},
+        {"INCLUDE", DIR_INCLUDE},
+        {"ONCE", DIR_ONCE},
+        {"MACRO", DIR_MACRO},
+        {"ENDM", DIR_ENDM},
+        {"LOCAL", DIR_LOCAL},
+    };
+
+    Mnemonic key = MakeMnemonicN(op.data(), op.size());
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i ++) {
+        if (CompareMnemonic(key, MakeMnemonic(names[i].name))) return names[i].dir;
+    }
+
+    return DIR_NONE;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::LookupSymbol(std::string_view) returns the Symbol for name, or NULL, counting the
+// lookup if there are Stats.  The SymbolTable counts nothing itself, so its Lookup() is a plain
+// read; without Stats, this is only that read.
+//-----------------------------------------------------------------------------------------------
+Symbol *Parser::LookupSymbol(std::string_view name)
+{
+    Symbol *sym = symTab.Lookup(name);
+
+    if (stats) {
+        stats->lookups ++;
+        if (sym) stats->hits ++;
+    }
+
+    return sym;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Include() handles `INCLUDE "file"`.
+//-----------------------------------------------------------------------------------------------
+void Parser::Include(void)
+{
+    if (opLast - opFirst != 1 || tokens[opFirst].type != TOK_STRING) {
+        Error("INCLUDE expects a quoted file name");
+        return;
+    }
+
+    // -- the rest of the expansion would be read before the file
+    if (macros.Expanding()) {
+        Error("INCLUDE is not allowed in a macro");
+        return;
+    }
+
+    std::string_view name = Lexer::Text(line, tokens[opFirst]);
+    name = name.substr(1, name.size() - 2);
+
+    // -- an empty name is how the FileStack is asked for stdin
+    if (name.find_first_not_of(" \t") == std::string_view::npos) {
+        Error("INCLUDE is missing a file name");
+        return;
+    }
+
     try {
-        size_t position = 0;
+        fStack.Push(std::string(name));
+    } catch (std::exception &e) {
+        Error(e.what());
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Cpu() handles `CPU name...`.  Each name is either a processor, which replaces the
+// active processor, or a feature (FPU, MMX, ...), which is enabled -- or disabled when it is
+// written with a NO prefix (NOFPU).  So `CPU 8086 NOUNDOC` is an 8086 without the undocumented
+// instructions, and `CPU FPU` turns the FPU back on without changing the processor.
+//-----------------------------------------------------------------------------------------------
+void Parser::Cpu(void)
+{
+    static const struct {
+        const char *name;
+        uint32_t bits;
+        bool feature;
+    } names[] = {
+        {"8086", _8086, false},
+        {"186", _186, false},
+        {"286", _286, false},
+        {"386", _386, false},
+        {"486", _486, false},
+        {"586", _586, false},
+        {"PENTIUM", _PENTIUM, false},
+        {"686", _686, false},
+        {"PPRO", _PPRO, false},
+        {"P2", _P2, false},
+        {"P3", _P3, false},
+        {"KATMAI", _KATMAI, false},
+        {"P4", _P4, false},
+        {"WILLAMETTE", _WILLAMETTE, false},
+        {"PRESCOTT", _PRESCOTT, false},
+        {"X64", _X64, false},
+        {"IA64", _IA64, false},
+        {"PRIV", _PRIV, true},
+        {"3DNOW", _3DNOW, true},
+        {"CYRIX", _CYRIX, true},
+        {"FPU", _FPU, true},
+        {"MMX", _MMX, true},
+        {"SSE", _SSE, true},
+        {"SSE2", _SSE2, true},
+        {"UNDOC", _UNDOC, true},
+    };
+
+    uint32_t newIsa = isa;
 
-        // -- first, assume we have a blank line
-        label = opCode = operand = comment = "";
-        if (line == "") return;
+    if (opFirst == opLast) {
+        Error("CPU expects a processor or feature name");
+        return;
+    }
 
-        // -- strip the terminating '\n' character
-        line = rtrim(line, "\n\r");
-        if (line == "") return;
+    for (size_t i = opFirst; i < opLast; i ++) {
+        std::string_view name = Lexer::Text(line, tokens[i]);
+        bool enable = true;
+        size_t n;
 
-        // -- OK, the easiest thing to do is to identify and strip off any comment
-        position = line.find(';');
-        if (position != (size_t)-1) {
-            comment = line.substr(position);
-            line = line.substr(0, position);
+        if (tokens[i].type == TOK_COMMA) continue;
+
+        if (name.size() > 2 && (name[0] == 'n' || name[0] == 'N')
+                && (name[1] == 'o' || name[1] == 'O')) {
+            name.remove_prefix(2);
+            enable = false;
         }
 
-        cleanLine = rtrim(line);
-        if (line == "") return;
+        Mnemonic key = MakeMnemonicN(name.data(), name.size());
 
-        // -- with comments removed from the equation, if the first position contains whitespace,
-        //    then the first thing we have is an OpCode;  Otherwise we have a label.
-        if (line.find_first_not_of(" \f\n\r\t\v") == 0) {
-            position = line.find_first_of(" \f\n\r\t\v");
-            label = line.substr(0, position);
-            line = line.substr(position);
+        for (n = 0; n < sizeof(names) / sizeof(names[0]); n ++) {
+            if (CompareMnemonic(key, MakeMnemonic(names[n].name))) break;
         }
 
-        line = ltrim(line);
+        if (n == sizeof(names) / sizeof(names[0]) || (!enable && !names[n].feature)) {
+            Error("unknown CPU or feature '" + std::string(Lexer::Text(line, tokens[i])) + "'");
+            return;
+        }
 
-        if (line == "") return;
+        if (!names[n].feature) newIsa = (newIsa & ~ISA_CPU_MASK) | names[n].bits;
+        else if (enable) newIsa |= names[n].bits;
+        else newIsa &= ~names[n].bits;
+    }
 
-        // -- Now, we can look for an opcode  We really should have one at this point in the code
-        position = line.find_first_of(" \f\n\r\t\v");
-        opCode = line.substr(0, position);
-        line = ltrim(line.substr(position));
+    SelectIsa(newIsa);
+}
 
-        if (line == "") return;
+//-----------------------------------------------------------------------------------------------
+// Parser::Bits() handles `BITS 16`, `BITS 32`, and `BITS 64`.
+//-----------------------------------------------------------------------------------------------
+void Parser::Bits(void)
+{
+    int64_t bits = 0;
 
-        // -- Finally, the rest is the operands
-        operand = trim(line);
-    } catch (...) {
+    if (opLast - opFirst != 1 || tokens[opFirst].type != TOK_NUMBER
+            || !Lexer::NumberValue(Lexer::Text(line, tokens[opFirst]), bits)
+            || (bits != 16 && bits != 32 && bits != 64)) {
+        Error("BITS expects 16, 32, or 64");
         return;
     }
-#endif
+
+    SelectIsa((isa & ~ISA_BITS_MASK) | (bits == 16 ? _16BITS : bits == 32 ? _32BITS : _64BITS));
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Org() handles `ORG address`, the address the code will be loaded at.  It applies to
+// the whole section, so it must come before any code.
+//-----------------------------------------------------------------------------------------------
+void Parser::Org(void)
+{
+    if (!ParseOperands()) return;
+
+    const Operand &op = operands[0];
+
+    if (opCount != 1 || !op.IsImmediate() || op.cls == OC_FAR || op.IsRelocatable()
+            || op.value < 0) {
+        Error("ORG expects a constant address");
+        return;
+    }
+
+    if (code.Size()) {
+        Error("ORG must come before any code");
+        return;
+    }
+
+    origin = op.value;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Equ(std::string_view, size_t) defines name as the value of the expression in tokens
+// [first..opLast).  A constant is simply the symbol's value; anything else is kept in the
+// ExprPool for the Relaxer.  A symbol that was referenced before this has its Fixups released,
+// to be resolved at the end like those of a label.
+//-----------------------------------------------------------------------------------------------
+void Parser::Equ(std::string_view name, size_t first)
+{
+    Symbol *sym = LookupSymbol(name);
+    size_t i = first;
+    ExprValue v;
+
+    if (sym && (sym->GetType() == Symbol::SYM_LABEL || sym->GetType() == Symbol::SYM_EQU)) {
+        Error("'" + std::string(name) + "' is already defined at "
+                + fStack.Files().Name(sym->FileNum()) + ":" + std::to_string(sym->LineNum()));
+        return;
+    }
+
+    // -- for `name EQU value`, opRows are the rows for name
+    if (opRows || (sym && sym->GetType() != Symbol::SYM_UNK)) {
+        Error("'" + std::string(name) + "' is a reserved word");
+        return;
+    }
+
+    if (!ParseExpr(i, opLast, v, false)) return;
+
+    if (i < opLast) {
+        Error("unexpected '" + std::string(Lexer::Text(line, tokens[i])) + "' in expression");
+        return;
+    }
+
+    sym = symTab.Insert(name, Symbol::SYM_EQU, fStack.Location());
+
+    if (v.IsConstant()) sym->SetValue(v.k);
+    else sym->SetExpr(exprs.Leaf(v, (uint32_t)code.Size()));
+
+    relaxer.Defined(sym);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Macro() handles `name MACRO [param [, param]...]`, the start of a macro definition.
+// Even when there is an error in this line the definition is started, so that its body is not
+// taken for code.
+//-----------------------------------------------------------------------------------------------
+void Parser::Macro(void)
+{
+    Symbol *sym = LookupSymbol(opCode);
+    bool ok = true;
+
+    if (macros.Expanding()) {
+        Error("a macro cannot be defined by a macro");
+        return;
+    }
+
+    uint32_t m = macros.Begin(fStack.Location());
+
+    if (sym && sym->GetType() == Symbol::SYM_MACRO) {
+        Error("macro '" + std::string(opCode) + "' is already defined at "
+                + fStack.Files().Name(sym->FileNum()) + ":" + std::to_string(sym->LineNum()));
+        ok = false;
+    } else if (opRows || LookupDirective(opCode) != DIR_NONE
+            || (sym && sym->GetType() != Symbol::SYM_UNK)) {
+        Error("'" + std::string(opCode) + "' is a reserved word");
+        ok = false;
+    }
+
+    for (size_t i = opFirst + 1; i < opLast; i += 2) {
+        std::string_view name = Lexer::Text(line, tokens[i]);
+
+        if (tokens[i].type != TOK_IDENT
+                || (i + 1 < opLast && tokens[i + 1].type != TOK_COMMA)) {
+            Error("expected a parameter name");
+            ok = false;
+            break;
+        }
+
+        if (!macros.AddParam(name)) {
+            Error("duplicate parameter '" + std::string(name) + "'");
+            ok = false;
+        }
+    }
+
+    if (ok) symTab.Insert(opCode, Symbol::SYM_MACRO, fStack.Location())->SetValue(m);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Body() adds a line to the body of the macro being defined, or ends the definition at
+// the ENDM.  The LOCAL lines must come before the body.
+//-----------------------------------------------------------------------------------------------
+void Parser::Body(void)
+{
+    Directive dir = (opCode.empty() || opRows ? DIR_NONE : LookupDirective(opCode));
+
+    if (dir == DIR_ENDM) {
+        macros.End();
+        return;
+    }
+
+    if (dir == DIR_LOCAL) {
+        if (macros.HasBody()) {
+            Error("LOCAL must come before the body of the macro");
+            return;
+        }
+
+        for (size_t i = opFirst; i < opLast; i += 2) {
+            std::string_view name = Lexer::Text(line, tokens[i]);
+
+            if (tokens[i].type != TOK_IDENT
+                    || (i + 1 < opLast && tokens[i + 1].type != TOK_COMMA)) {
+                Error("expected a label name");
+                return;
+            }
+
+            if (!macros.AddLocal(name)) Error("duplicate local '" + std::string(name) + "'");
+        }
+
+        return;
+    }
+
+    if (opFirst < opLast && tokens[opFirst].type == TOK_IDENT
+            && LookupDirective(Lexer::Text(line, tokens[opFirst])) == DIR_MACRO) {
+        Error("a macro cannot be defined inside another");
+        return;
+    }
+
+    if (label.empty() && opCode.empty() && opFirst == opLast) return;
+
+    macros.AddLine(line, tokens);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Expand(const Symbol*) starts the expansion of a macro.  Its lines are then read
+// before the next line of the file.
+//-----------------------------------------------------------------------------------------------
+void Parser::Expand(const Symbol *sym)
+{
+    std::string why;
+
+    if (!macros.Expand((uint32_t)sym->Value(), line, tokens, opFirst, opLast, why)) Error(why);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::SelectIsa(uint32_t) makes newIsa the active ISA.  The view for it is shared by all the
+// Parsers and is only built the first time any of them asks for it.
+//-----------------------------------------------------------------------------------------------
+void Parser::SelectIsa(uint32_t newIsa)
+{
+    if (view && newIsa == isa) return;
+
+    const OpCodeView *v = OpCodeSelect(newIsa);
+    if (!v) throw std::bad_alloc();
+
+    isa = newIsa;
+    view = v;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ParseOperands() splits the operand tokens at the commas and parses each operand.  It
+// returns false (having reported the error) if any of them is not valid.
+//-----------------------------------------------------------------------------------------------
+bool Parser::ParseOperands(void)
+{
+    size_t first = opFirst;
+
+    opCount = 0;
+    for (size_t i = 0; i < 3; i ++) operands[i] = Operand();
+    if (opFirst == opLast) return true;
+
+    for (size_t i = opFirst; i <= opLast; i ++) {
+        if (i < opLast && tokens[i].type != TOK_COMMA) continue;
+
+        if (opCount == 3) {
+            Error("too many operands");
+            return false;
+        }
+
+        if (!ParseOperand(first, i, operands[opCount ++])) return false;
+        first = i + 1;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ParseOperand(size_t, size_t, Operand&) parses the tokens [first..last) of a single
+// operand.  An operand is one of:
+//
+// [qualifier] register
+// [qualifier] [segment:] `[` [segment:] expr `]` -- where expr may add BX/BP and SI/DI
+// [qualifier] expr
+// expr `:` expr                                  -- an immediate seg:off for a far JMP or CALL
+//-----------------------------------------------------------------------------------------------
+bool Parser::ParseOperand(size_t first, size_t last, Operand &op)
+{
+    size_t i = first;
+    ExprValue v;
+
+    if (i < last && tokens[i].type == TOK_QUALIFIER) op.qual = tokens[i ++].aux;
+    if (i < last && tokens[i].type == TOK_SEGMENT) op.seg = tokens[i ++].aux;
+
+    if (i == last) {
+        Error("missing operand");
+        return false;
+    }
+
+    // -- a register
+    if (tokens[i].type == TOK_REGISTER && i + 1 == last && op.seg == R_NONE) {
+        op.reg = tokens[i].aux;
+        op.cls = OC_AL + op.reg;
+        return true;
+    }
+
+    // -- memory
+    if (tokens[i].type == TOK_LBRACKET) {
+        if (tokens[last - 1].type != TOK_RBRACKET) {
+            Error("expected ']'");
+            return false;
+        }
+
+        i ++;
+        if (op.seg == R_NONE && tokens[i].type == TOK_SEGMENT) op.seg = tokens[i ++].aux;
+        if (!ParseExpr(i, last - 1, v, true)) return false;
+
+        if (i < last - 1) {
+            Error("unexpected '" + std::string(Lexer::Text(line, tokens[i])) + "' in operand");
+            return false;
+        }
+
+        SetValue(op, v);
+
+        bool direct = (op.base == R_NONE && op.index == R_NONE);
+
+        switch (op.qual) {
+        case Q_BYTE: op.cls = (direct ? OC_MOFFS8 : OC_MEM8); break;
+        case Q_WORD: op.cls = (direct ? OC_MOFFS16 : OC_MEM16); break;
+        case Q_DWORD:
+        case Q_FAR: op.cls = OC_MEM32; break;
+        default: op.cls = (direct ? OC_MOFFS : OC_MEM); break;
+        }
+
+        return true;
+    }
+
+    if (op.seg != R_NONE) {
+        Error("a segment override must be followed by a memory reference");
+        return false;
+    }
+
+    // -- an immediate, or a far seg:off
+    if (!ParseExpr(i, last, v, false)) return false;
+
+    if (i < last && tokens[i].type != TOK_COLON) {
+        Error("unexpected '" + std::string(Lexer::Text(line, tokens[i])) + "' in operand");
+        return false;
+    }
+
+    SetValue(op, v);
+
+    if (i < last) {
+        ExprValue off;
+
+        if (op.IsRelocatable()) {
+            Error("the segment of a far address must be a constant");
+            return false;
+        }
+
+        if (!ParseExpr(++ i, last, off, false)) return false;
+        if (i < last) {
+            Error("unexpected '" + std::string(Lexer::Text(line, tokens[i])) + "' in operand");
+            return false;
+        }
+
+        op.segment = (uint16_t)op.value;
+        SetValue(op, off);
+        op.cls = OC_FAR;
+        return true;
+    }
+
+    // -- a constant must fit in a word; an address is only known once the Relaxer has run
+    if (!op.IsRelocatable() && (op.value < -32768 || op.value > 65535)) {
+        Error("value out of range");
+        return false;
+    }
+
+    // -- one not known yet may be a byte; the row matched decides the width of its Fixup
+    op.cls = (op.IsRelocatable() ? (uint8_t)OC_IMMREL : ImmediateClass(op.value));
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ParseExpr(size_t&, size_t, ExprValue&, bool, int) parses an expression from tokens[i]
+// by precedence climbing: a unary term, then any binary operators that bind at least as tightly
+// as minPrec, each with a right-hand side that binds more tightly (so all of them associate to
+// the left).  It stops at the first token that is not a binary operator -- a `)`, or the `:` of
+// a far address -- leaving i there.  Inside a memory reference the terms may also be the base
+// and index registers.
+//-----------------------------------------------------------------------------------------------
+bool Parser::ParseExpr(size_t &i, size_t last, ExprValue &v, bool memory, int minPrec)
+{
+    if (!ParseUnary(i, last, v, memory)) return false;
+
+    while (i < last) {
+        TokenType t = tokens[i].type;
+        int prec = ExprPool::Precedence(t);
+        ExprValue rhs;
+
+        if (!prec || prec < minPrec) break;
+
+        if (!ParseExpr(++ i, last, rhs, memory, prec + 1)) return false;
+        if (!Combine(ExprPool::BinaryOp(t), v, rhs)) return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ParseUnary(size_t&, size_t, ExprValue&, bool) parses a term with any unary `+`, `-`,
+// or `~` in front of it, or an expression in parentheses.
+//-----------------------------------------------------------------------------------------------
+bool Parser::ParseUnary(size_t &i, size_t last, ExprValue &v, bool memory)
+{
+    if (i == last) {
+        Error("expression expected");
+        return false;
+    }
+
+    const Token &t = tokens[i ++];
+
+    switch (t.type) {
+    case TOK_PLUS:
+        return ParseUnary(i, last, v, memory);
+
+    case TOK_MINUS:
+    case TOK_TILDE: {
+        ExprOp op = (t.type == TOK_MINUS ? EX_NEG : EX_NOT);
+
+        if (!ParseUnary(i, last, v, memory)) return false;
+
+        if (v.HasRegisters()) {
+            Error("invalid effective address");
+            return false;
+        }
+
+        if (v.IsConstant()) v.k = (op == EX_NEG ? -v.k : ~v.k);
+        else {
+            uint32_t leaf = exprs.Leaf(v, (uint32_t)code.Size());
+
+            v.node = exprs.Add(ExprNode { op, leaf, 0, 0, 0, NULL });
+            v.k = 0;
+            v.sym = NULL;
+            v.here = false;
+        }
+
+        return true;
+    }
+
+    case TOK_LPAREN:
+        if (!ParseExpr(i, last, v, memory)) return false;
+
+        if (i == last || tokens[i].type != TOK_RPAREN) {
+            Error("expected ')'");
+            return false;
+        }
+
+        i ++;
+        return true;
+
+    default:
+        return ParsePrimary(t, v, memory);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ParsePrimary(const Token&, ExprValue&, bool) gives the value of a single term.  `$$`
+// is the start of the section, the ORG.  An EQU that is a constant is folded in.  A label or a
+// symbol that is not defined yet -- and `$`, the current instruction -- cannot be, since its
+// address is not final until the Relaxer has run: it is recorded in the value instead.
+//-----------------------------------------------------------------------------------------------
+bool Parser::ParsePrimary(const Token &t, ExprValue &v, bool memory)
+{
+    std::string_view text = Lexer::Text(line, t);
+
+    switch (t.type) {
+    case TOK_NUMBER:
+        if (!Lexer::NumberValue(text, v.k)) {
+            Error("invalid number '" + std::string(text) + "'");
+            return false;
+        }
+
+        return true;
+
+    case TOK_DOLLAR:
+        if (text.size() > 1) v.k = origin;
+        else v.here = true;
+        return true;
+
+    case TOK_REGISTER:
+        if (!memory) break;
+
+        if (t.aux == R_BX || t.aux == R_BP) v.base = t.aux;
+        else if (t.aux == R_SI || t.aux == R_DI) v.index = t.aux;
+        else {
+            Error("invalid effective address");
+            return false;
+        }
+
+        return true;
+
+    case TOK_IDENT: {
+        Symbol *sym = LookupSymbol(text);
+
+        if (sym && sym->GetType() == Symbol::SYM_EQU) {
+            const ExprNode *n = (sym->Expr() ? &exprs[sym->Expr()] : NULL);
+
+            if (!n) v.k = sym->Value();
+            else if (n->op == EX_SYM) {
+                v.sym = n->sym;
+                v.k = n->value;
+            } else v.node = sym->Expr();
+
+            return true;
+        }
+
+        if (sym && sym->GetType() != Symbol::SYM_LABEL && sym->GetType() != Symbol::SYM_UNK) {
+            Error("'" + std::string(text) + "' is a reserved word");
+            return false;
+        }
+
+        v.sym = (sym ? sym : symTab.Insert(text, Symbol::SYM_UNK, fStack.Location()));
+        return true;
+    }
+
+    default:
+        break;
+    }
+
+    Error("unexpected '" + std::string(text) + "' in operand");
+    return false;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Combine(ExprOp, ExprValue&, const ExprValue&) applies a binary operator, leaving the
+// result in a.  Whatever can be folded now is: constants, a label plus or minus a constant, the
+// difference of 2 labels with no branch between them, and anything minus itself.  Only what is
+// left becomes nodes in the ExprPool.  The registers of a memory reference may only be added.
+//-----------------------------------------------------------------------------------------------
+bool Parser::Combine(ExprOp op, ExprValue &a, const ExprValue &b)
+{
+    uint8_t base = a.base;
+    uint8_t index = a.index;
+    uint32_t pa, pb;
+
+    if (b.HasRegisters()) {
+        if (op != EX_ADD || (base != R_NONE && b.base != R_NONE)
+                || (index != R_NONE && b.index != R_NONE)) {
+            Error("invalid effective address");
+            return false;
+        }
+
+        if (b.base != R_NONE) base = b.base;
+        if (b.index != R_NONE) index = b.index;
+    } else if (a.HasRegisters() && op != EX_ADD && op != EX_SUB) {
+        Error("invalid effective address");
+        return false;
+    }
+
+    if (a.IsConstant() && b.IsConstant()) {
+        if (!ExprPool::Fold(op, a.k, b.k, a.k)) {
+            Error("division by zero");
+            return false;
+        }
+    } else if ((op == EX_ADD || op == EX_SUB) && b.IsConstant() && (!a.node || !b.k)) {
+        a.k += (op == EX_ADD ? b.k : -b.k);
+    } else if (op == EX_ADD && a.IsConstant() && (!b.node || !a.k)) {
+        a.k += b.k;
+        a.sym = b.sym;
+        a.here = b.here;
+        a.node = b.node;
+    } else if (op == EX_SUB && !a.node && !b.node && a.sym == b.sym && a.here == b.here) {
+        a.k -= b.k;
+        a.sym = NULL;
+        a.here = false;
+    } else if (op == EX_SUB && Staging(a, pa) && Staging(b, pb) && relaxer.Settled(pa, pb)) {
+        a.k = (int64_t)pa + a.k - pb - b.k;
+        a.sym = NULL;
+        a.here = false;
+    } else {
+        uint32_t pos = (uint32_t)code.Size();
+
+        a.node = exprs.Add(ExprNode { op, exprs.Leaf(a, pos), exprs.Leaf(b, pos), 0, 0, NULL });
+        a.k = 0;
+        a.sym = NULL;
+        a.here = false;
+    }
+
+    a.base = base;
+    a.index = index;
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Staging(const ExprValue&, uint32_t&) gives the staging offset of a value that is `$` or
+// a label that is already defined, less the constant part.
+//-----------------------------------------------------------------------------------------------
+bool Parser::Staging(const ExprValue &v, uint32_t &pos) const
+{
+    if (v.node) return false;
+
+    if (v.here) pos = (uint32_t)code.Size();
+    else if (v.sym && v.sym->IsDefined() && v.sym->GetType() == Symbol::SYM_LABEL) {
+        pos = (uint32_t)v.sym->Value();
+    }
+    else return false;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::SetValue(Operand&, const ExprValue&) copies a parsed expression into an operand.
+//-----------------------------------------------------------------------------------------------
+void Parser::SetValue(Operand &op, const ExprValue &v)
+{
+    op.value = v.k;
+    op.sym = v.sym;
+    op.here = v.here;
+    op.expr = v.node;
+    op.base = v.base;
+    op.index = v.index;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::MatchOperands() finds the OpCodeTable rows that can encode the instruction from the
+// signature of its operands.  When a memory operand has no size and the rows that match do not
+// agree on one, the instruction is ambiguous (`INC [BX]` could be a byte or a word).
+//-----------------------------------------------------------------------------------------------
+bool Parser::MatchOperands(void)
+{
+    uint32_t sig = OPERAND_SIG(operands[0].cls, operands[1].cls, operands[2].cls);
+
+    auto typeSize = [](OperandType t) {
+        switch (t) {
+        case R8: case RM8: case M8: case MOFFS8: return 1;
+        case R16: case RM16: case M16: case MOFFS16: return 2;
+        default: return 0;
+        }
+    };
+
+    matches = OpCodeMatch(view, opRows, sig, &matchCount);
+
+    if (stats) {
+        stats->instructions ++;
+        stats->candidates += matchCount;
+    }
+
+    if (!matches) {
+        const OpCodeView *all = OpCodeSelect(ISA_DEFAULT);
+        size_t n;
+
+        // -- say so when it is the CPU directive that excludes the instruction
+        matchCount = 0;
+        if (!OpCodeRows(view, opRows, &n)) {
+            Error("'" + std::string(opCode) + "' is not available on the selected CPU");
+        } else if (isa != ISA_DEFAULT && all && OpCodeMatch(all, opRows, sig, &n)) {
+            Error("this form of '" + std::string(opCode)
+                    + "' is not available on the selected CPU");
+        } else Error("invalid combination of opcode and operands");
+
+        return false;
+    }
+
+    for (size_t p = 0; p < opCount; p ++) {
+        if (!operands[p].IsUnsized()) continue;
+
+        for (size_t k = 1; k < matchCount; k ++) {
+            if (typeSize(matches[k]->type[p]) != typeSize(matches[0]->type[p])) {
+                Error("operation size not specified");
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Emit() encodes the instruction into the code Section, with the first of the matching
+// rows that can encode it.  Room is reserved for the longest instruction (the sizes in the table
+// are the shortest form of each row), so the bytes are written straight into the section.
+//
+// A relative branch is only given a short slot and handed to the Relaxer, unless it is written
+// `NEAR` and has a near form.  Any other operand that refers to a label, and any other relative
+// field, gets a Fixup for the field it was encoded in.
+//-----------------------------------------------------------------------------------------------
+void Parser::Emit(void)
+{
+    const OpCodeEntry *shortRow = NULL;
+    const OpCodeEntry *nearRow = NULL;
+    const Operand &target = operands[0];
+    uint32_t pos = (uint32_t)code.Size();
+
+    for (size_t k = 0; k < matchCount; k ++) {
+        if (matches[k]->type[0] == REL8 && !shortRow) shortRow = matches[k];
+        if (matches[k]->type[0] == REL16 && !nearRow) nearRow = matches[k];
+    }
+
+    if (shortRow && (target.qual != Q_NEAR || !nearRow)) {
+        uint8_t slot[2] = {shortRow->byteCode[0], 0};
+
+        code.Append(slot, sizeof(slot));
+        relaxer.AddBranch(pos, shortRow, nearRow, target.sym, target.here, target.value,
+                target.expr, target.qual == Q_SHORT, fStack.Location());
+        return;
+    }
+
+    uint8_t *p = code.Reserve(Encoder::MAX_LENGTH);
+    Encoder::Field fields[3];
+
+    for (size_t k = 0; k < matchCount; k ++) {
+        if (matches[k]->type[0] == REL8) continue;
+
+        size_t n = Encoder::Encode(matches[k], operands, pos, p, fields);
+        if (!n) continue;
+
+        code.Commit(p + n);
+
+        for (size_t i = 0; i < opCount; i ++) {
+            const Operand &op = operands[i];
+
+            // -- a relative field moves with the instruction, even to a constant address
+            if ((!op.IsRelocatable() && !fields[i].relative) || !fields[i].size) continue;
+
+            relaxer.AddFixup(Fixup { pos + fields[i].offset, pos, op.sym, op.value, op.expr,
+                    fStack.Location(), 0, (uint8_t)n, fields[i].size, fields[i].relative,
+                    op.here });
+        }
+
+        return;
+    }
+
+    Error("invalid combination of opcode and operands");
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::DefineLabel(std::string_view, int64_t) defines a label with the given value.
+//-----------------------------------------------------------------------------------------------
+void Parser::DefineLabel(std::string_view name, int64_t value)
+{
+    Symbol *sym = LookupSymbol(name);
+
+    if (sym && (sym->GetType() == Symbol::SYM_LABEL || sym->GetType() == Symbol::SYM_EQU)) {
+        Error("'" + std::string(name) + "' is already defined at "
+                + fStack.Files().Name(sym->FileNum()) + ":" + std::to_string(sym->LineNum()));
+        return;
+    }
+
+    if (sym && sym->GetType() != Symbol::SYM_UNK) {
+        Error("'" + std::string(name) + "' is a reserved word");
+        return;
+    }
+
+    sym = symTab.Insert(name, Symbol::SYM_LABEL, fStack.Location());
+    sym->SetValue(value);
+    relaxer.AddLabel(sym);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Error(const std::string&) reports an error at the current line.
+//-----------------------------------------------------------------------------------------------
+void Parser::Error(const std::string &msg)
+{
+    diag << fStack.FileName() << ":" << fStack.LineNum() << ": error: " << msg << '\n';
+    errors ++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ErrorAt(SrcLoc, const std::string&) reports an error found after the line has gone,
+// at the line it was on.
+//-----------------------------------------------------------------------------------------------
+void Parser::ErrorAt(SrcLoc loc, const std::string &msg)
+{
+    diag << fStack.Files().Name(loc.file) << ":" << loc.line << ": error: " << msg << '\n';
+    errors ++;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::NextLine() makes the next line the current one: the next line of the innermost macro
+// expansion, which is already lexed, or else the next line from the file stack -- which is also
+// already lexed if its file was lexed ahead.  It returns false at the end of the source.
+//-----------------------------------------------------------------------------------------------
+bool Parser::NextLine(void)
+{
+    std::string_view text;
+    const Token *first;
+    size_t count;
+
+    if (macros.Expanding() && macros.Next(tokens)) {
+        line = macros.Text();
+        Split();
+        return true;
+    }
+
+    if (!fStack.ReadLine(text)) return false;
+
+    if (fStack.Tokens(first, count)) {
+        line = text;
+        tokens.assign(first, first + count);
+        Split();
+    } else ParseLine(text);
+
+    if (stats) stats->tokens += tokens.size();
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::ParseLine(std::string_view) is likely to be one of the most complicated functions in
+// the assembler.  It is responsible for parsing out a line into its possible components.  The
+// line is lexed once; Split() then finds the label, opcode, operand, and comment, which are just
+// views over the ranges of tokens that make them up.
+//-----------------------------------------------------------------------------------------------
+void Parser::ParseLine(std::string_view text)
+{
+    line = text;
+    tokens.clear();
+    lexer.Lex(line, tokens);
+    Split();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Parser::Split() splits the tokens of the current line into its parts.
+//-----------------------------------------------------------------------------------------------
+void Parser::Split(void)
+{
+    size_t i = 0;
+
+    // -- first, assume we have a blank line
+    label = opCode = operand = comment = std::string_view();
+    opFirst = opLast = 0;
+    opRows = NULL;
+    opRowCount = 0;
+    opCount = 0;
+    matches = NULL;
+    matchCount = 0;
+
+    if (tokens.empty()) return;
+
+    if (tokens[i].type == TOK_LABEL) label = Lexer::Text(line, tokens[i ++]);
+    if (tokens[i].type == TOK_MNEMONIC) {
+        opCode = Lexer::Text(line, tokens[i ++]);
+        opRows = OpCodeLookup(MakeMnemonicN(opCode.data(), opCode.size()), &opRowCount);
+    }
+
+    // -- the rest, up to any comment, is the operands
+    opFirst = opLast = i;
+    while (tokens[opLast].type != TOK_EOL && tokens[opLast].type != TOK_COMMENT) opLast ++;
+
+    if (opLast > opFirst) {
+        size_t start = tokens[opFirst].offset;
+        operand = line.substr(start, tokens[opLast - 1].offset + tokens[opLast - 1].length - start);
+    }
+
+    if (tokens[opLast].type == TOK_COMMENT) comment = Lexer::Text(line, tokens[opLast]);
 }
 
 //===============================================================================================
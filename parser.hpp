@@ -22,6 +22,25 @@
 // 2015-02-09  ADCL   #263    The functions ltrim(), rtrim(), and trim () are moving to their
 //                            own file -- utils.hpp.
 // 2015-02-09  ADCL   #257    This file is renamed to parser.hpp.
+// 2026-10-16  ADCL   U-002   ParseLine() takes a std::string_view.
+// 2026-10-16  ADCL   U-003   The Parser keeps the current line's tokens from the Lexer.
+// 2026-10-16  ADCL   U-005   The Parser looks up the OpCodeTable rows for the opcode.
+// 2026-10-16  ADCL   U-008   The Parser owns its FileStack and handles INCLUDE and ONCE.
+// 2026-10-16  ADCL   U-009   The Parser owns its SymbolTable and writes to its own diagnostics.
+// 2026-10-16  ADCL   U-010   The Parser parses the operands and matches them to OpCodeTable rows.
+// 2026-10-16  ADCL   U-011   The CPU and BITS directives select the OpCodeView matched against.
+// 2026-10-16  ADCL   U-012   The Parser defines labels and encodes instructions into its Section.
+// 2026-10-16  ADCL   U-013   Branches and label references are resolved by the Parser's Relaxer.
+// 2026-10-16  ADCL   U-014   The labels and relocations are available for the object file.
+// 2026-10-16  ADCL   U-015   Added the ORG directive.
+// 2026-10-16  ADCL   U-016   Undefined symbols may be left for the linker (AllowExternals()).
+// 2026-10-16  ADCL   U-017   Operands are full expressions, folded as they are parsed; added EQU.
+// 2026-10-16  ADCL   U-018   Added macros; an expanded line comes to the Parser already lexed.
+// 2026-10-16  ADCL   U-019   The files included are available for the assembly cache.
+// 2026-10-16  ADCL   U-021   Relative file names may be from a directory given to the constructor.
+// 2026-10-16  ADCL   U-023   A large file may be lexed ahead on several threads (SetLexThreads()).
+// 2026-10-16  ADCL   U-024   Or read and lexed by a pipeline alongside the Parser (SetPipeline()).
+// 2026-10-16  ADCL   U-025   Stages of a parse may be counted and timed into a Stats (SetStats()).
 //
 //===============================================================================================
 
@@ -32,30 +51,119 @@
 #error The file 'parser.hpp' is not being compiled by a C++ compiler.
 #endif
 
+#include "OpCodeTable.h"
+#include "expr.hpp"
 #include "filestack.hpp"
+#include "lexer.hpp"
+#include "macro.hpp"
+#include "operand.hpp"
+#include "relax.hpp"
+#include "section.hpp"
+#include "stats.hpp"
+#include "symtab.h"
 
+#include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 //-----------------------------------------------------------------------------------------------
 // The Parser class is setup to take a file and parse it into its individual lines.  The
 // constructor receives as a parameter the name of the file to parse; defaulting to "" if no file
 // is specified.  It then sets up it file stack and opens the initial file.
 //
-// The function Parser::Parse() is then called to do the work of parsing.
+// The function Parser::Parse() is then called to do the work of parsing.  Errors are reported
+// as they are found, with the file and line, and counted; parsing continues with the next line.
+// They are written to the diag stream, so a caller assembling several files at once can give
+// each Parser its own buffer.  Everything a Parser uses is its own (or read-only and shared), so
+// different Parsers may run on different threads.
 //-----------------------------------------------------------------------------------------------
 class Parser {
 public:
-    Parser(const std::string &f = "");
+    Parser(const std::string &f = "", std::ostream &d = std::cerr, const std::string &dir = "");
     virtual ~Parser() {};
 
+private:
+    Parser(const Parser &);
+    Parser &operator=(const Parser &);
+
 public:
     void Parse(void);                       // eventually will return the AST
+    void AddIncludePath(const std::string &dir) { fStack.AddIncludePath(dir); };
+    void SetLexThreads(unsigned n) { fStack.SetLexThreads(n); };
+    void SetPipeline(bool p) { fStack.SetPipeline(p); };
+    void SetStats(Stats *s) { stats = s; fStack.SetStats(s); };
+    int Errors(void) const { return errors; };
+    SymbolTable &Symbols(void) { return symTab; };
+    const Section &Code(void) const { return code; };
+    const std::vector<Symbol *> &Labels(void) const { return relaxer.Labels(); };
+    const std::vector<Reloc> &Relocs(void) const { return relaxer.Relocs(); };
+    int64_t Origin(void) const { return origin; };
+    void AllowExternals(bool allow) { externals = allow; };
+    const std::vector<std::string> &Includes(void) const { return fStack.Included(); };
+
+private:
+    typedef enum {DIR_NONE, DIR_CPU, DIR_BITS, DIR_MODEL, DIR_ORG, DIR_EVEN, DIR_EQU,
+            DIR_INCLUDE, DIR_ONCE, DIR_MACRO, DIR_ENDM, DIR_LOCAL} Directive;
 
 private:
-    FileStack &fStack;
+    FileStack fStack;
+    SymbolTable symTab;
+    std::ostream &diag;
+    int errors;
+    Lexer lexer;
+    std::vector<Token> tokens;              // the tokens for the current line
+    std::string_view line;                  // the current line; tokens index into this
+    std::string_view label;
+    std::string_view opCode;
+    std::string_view operand;
+    std::string_view comment;
+    size_t opFirst;                         // tokens[opFirst..opLast) are the operands
+    size_t opLast;
+    const OpCodeEntry *opRows;              // the OpCodeTable rows for opCode, or NULL
+    size_t opRowCount;
+    Operand operands[3];
+    size_t opCount;
+    const OpCodeEntry *const *matches;      // the rows that can encode the instruction, best first
+    size_t matchCount;
+    uint32_t isa;                           // the active ISA, in the form of OpCodeEntry.flags
+    const OpCodeView *view;                 // the OpCodeTable rows available to isa
+    Section code;
+    int64_t origin;                         // the address the code is loaded at (ORG)
+    bool externals;                         // an undefined symbol is external, not an error
+    ExprPool exprs;                         // the expressions that could not be folded
+    Relaxer relaxer;
+    MacroTable macros;
+    Stats *stats;                           // what to count and time into, or NULL
 
 private:
-    void ParseLine(std::string line);
+    bool NextLine(void);
+    void ParseLine(std::string_view text);
+    void Split(void);
+    static Directive LookupDirective(std::string_view op);
+    Symbol *LookupSymbol(std::string_view name);
+    void Include(void);
+    void Cpu(void);
+    void Bits(void);
+    void Org(void);
+    void Equ(std::string_view name, size_t first);
+    void Macro(void);
+    void Body(void);
+    void Expand(const Symbol *sym);
+    void SelectIsa(uint32_t newIsa);
+    bool ParseOperands(void);
+    bool ParseOperand(size_t first, size_t last, Operand &op);
+    bool ParseExpr(size_t &i, size_t last, ExprValue &v, bool memory, int minPrec = 1);
+    bool ParseUnary(size_t &i, size_t last, ExprValue &v, bool memory);
+    bool ParsePrimary(const Token &t, ExprValue &v, bool memory);
+    bool Combine(ExprOp op, ExprValue &a, const ExprValue &b);
+    bool Staging(const ExprValue &v, uint32_t &pos) const;
+    static void SetValue(Operand &op, const ExprValue &v);
+    bool MatchOperands(void);
+    void Emit(void);
+    void DefineLabel(std::string_view name, int64_t value);
+    void Error(const std::string &msg);
+    void ErrorAt(SrcLoc loc, const std::string &msg);
 };
 
 //===============================================================================================
@@ -0,0 +1,160 @@
+//===============================================================================================
+// pipeline.cc -- This file contains the class implementation for reading and lexing a file on
+// threads of their own, ahead of the Parser.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-024   Initial version
+//
+//===============================================================================================
+
+#include "pipeline.hpp"
+#include "utils.hpp"
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::LinePipe(const char*, size_t) puts every Batch on the free ring and starts the reader
+// and the lexer.
+//-----------------------------------------------------------------------------------------------
+LinePipe::LinePipe(const char *b, size_t size)
+        : base(b), end(b + size), batches(new Batch[BATCHES]), freeRing(BATCHES),
+        readRing(BATCHES), lexedRing(BATCHES), stop(false), current(NULL), index(0)
+{
+    for (size_t i = 0; i < BATCHES; i ++) {
+        batches[i].lines.reserve(BATCH_LINES);
+        batches[i].first.reserve(BATCH_LINES + 1);
+        Give(freeRing, &batches[i]);
+    }
+
+    reader = std::thread(&LinePipe::ReadStage, this);
+    lexer = std::thread(&LinePipe::LexStage, this);
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::~LinePipe() stops the reader and the lexer, wherever they are waiting.
+//-----------------------------------------------------------------------------------------------
+LinePipe::~LinePipe()
+{
+    stop.store(true, std::memory_order_relaxed);
+    reader.join();
+    lexer.join();
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::Take(SpscRing<Batch*>&) waits for a Batch on ring, and returns it; or NULL if the
+// pipe is stopped first.
+//-----------------------------------------------------------------------------------------------
+LinePipe::Batch *LinePipe::Take(SpscRing<Batch *> &ring)
+{
+    Batch *b;
+    Backoff wait;
+
+    while (!ring.TryPop(b)) {
+        if (stop.load(std::memory_order_relaxed)) return NULL;
+        wait.Pause();
+    }
+
+    return b;
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::Give(SpscRing<Batch*>&, Batch*) passes b on along ring.  Every ring has a slot for
+// every Batch, so this does not really wait.
+//-----------------------------------------------------------------------------------------------
+void LinePipe::Give(SpscRing<Batch *> &ring, Batch *b)
+{
+    Backoff wait;
+
+    while (!ring.TryPush(std::move(b))) wait.Pause();
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::ReadStage() is the reader thread: it fills each free Batch with the next lines.
+// The Batch that reaches the end of the file is the last.
+//-----------------------------------------------------------------------------------------------
+void LinePipe::ReadStage(void)
+{
+    const char *p = base;
+    Batch *b;
+
+    while ((b = Take(freeRing)) != NULL) {
+        b->lines.clear();
+        while (b->lines.size() < BATCH_LINES && p < end) b->lines.push_back(TakeLine(p, end));
+
+        // -- once given, the Batch is the lexer's
+        bool last = b->last = (p >= end);
+        Give(readRing, b);
+        if (last) return;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::LexStage() is the lexer thread: it lexes each line of each Batch read.
+//-----------------------------------------------------------------------------------------------
+void LinePipe::LexStage(void)
+{
+    Lexer lex;
+    Batch *b;
+
+    while ((b = Take(readRing)) != NULL) {
+        b->tokens.clear();
+        b->first.clear();
+
+        for (size_t i = 0; i < b->lines.size(); i ++) {
+            b->first.push_back((uint32_t)b->tokens.size());
+            lex.Lex(b->lines[i], b->tokens);
+        }
+
+        b->first.push_back((uint32_t)b->tokens.size());
+
+        bool last = b->last;
+        Give(lexedRing, b);
+        if (last) return;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::Fetch() makes sure current has a line left to take, handing back the Batch it has
+// finished with and waiting for the next.  It returns false at the end of the file.
+//-----------------------------------------------------------------------------------------------
+bool LinePipe::Fetch(void)
+{
+    if (current && index < current->lines.size()) return true;
+    if (current && current->last) return false;
+
+    if (current) Give(freeRing, current);
+    current = Take(lexedRing);
+    index = 0;
+
+    return index < current->lines.size();
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::AtEnd() is true once every line has been taken.
+//-----------------------------------------------------------------------------------------------
+bool LinePipe::AtEnd(void)
+{
+    return !Fetch();
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::Next(std::string_view&) takes the next line, or returns false at the end of the file.
+//-----------------------------------------------------------------------------------------------
+bool LinePipe::Next(std::string_view &line)
+{
+    if (!Fetch()) return false;
+
+    line = current->lines[index ++];
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// LinePipe::Tokens(const Token*&, size_t&) gives the tokens of the line Next() last took.  They
+// are valid until the next call to AtEnd() or Next().
+//-----------------------------------------------------------------------------------------------
+void LinePipe::Tokens(const Token *&first, size_t &count) const
+{
+    first = current->tokens.data() + current->first[index - 1];
+    count = current->first[index] - current->first[index - 1];
+}
+
+//===============================================================================================
@@ -0,0 +1,100 @@
+//===============================================================================================
+// pipeline.hpp -- This file contains the class definition for reading and lexing a file on
+// threads of their own, ahead of the Parser.
+//
+// A LinePipe runs the first two stages of an assembly as a pipeline: a reader thread splits the
+// file into lines, a lexer thread lexes them, and the Parser (on the thread that owns the pipe)
+// takes the lexed lines as it wants them.  Work moves between the stages in Batches of lines,
+// passed along SpscRings:
+//
+//     reader --(read)--> lexer --(lexed)--> Parser --(free)--> reader
+//
+// There is a fixed number of Batches, which go round and round; a stage that finds no Batch to
+// take waits for one.  So the Parser never has more than that many Batches of lines ahead of it,
+// however large the file, and however far behind the Parser falls (as it does while it reads an
+// include file, or expands a macro).
+//
+// The lines are split with TakeLine() and lexed with Lexer::Lex(), a line at a time, exactly as
+// InputFile::ReadLine() and the Parser would, so the Parser sees the same lines and tokens it
+// would have without the pipe.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-024   Initial version
+//
+//===============================================================================================
+
+#ifndef __PIPELINE_HPP__
+#define __PIPELINE_HPP__
+
+#ifndef __cplusplus
+#error The file 'pipeline.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "lexer.hpp"
+#include "ring.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The LinePipe class reads and lexes size bytes at base, which must stay valid for as long as
+// the pipe does.  AtEnd() is true once every line has been taken.  Next() takes the next line;
+// Tokens() then gives its tokens.  All three are only called by the thread that owns the pipe,
+// and AtEnd() and Next() may wait for the other stages to catch up.  Destroying the pipe stops
+// the other stages, whether or not every line was taken.
+//-----------------------------------------------------------------------------------------------
+class LinePipe {
+public:
+    LinePipe(const char *base, size_t size);
+    virtual ~LinePipe();
+
+private:
+    LinePipe(const LinePipe &);
+    LinePipe &operator=(const LinePipe &);
+
+public:
+    bool AtEnd(void);
+    bool Next(std::string_view &line);
+    void Tokens(const Token *&first, size_t &count) const;
+
+private:
+    static const size_t BATCHES = 8;
+    static const size_t BATCH_LINES = 256;
+
+    struct Batch {
+        std::vector<std::string_view> lines;
+        std::vector<Token> tokens;
+        std::vector<uint32_t> first;        // the tokens of line i are first[i] up to first[i + 1]
+        bool last;                          // this is the end of the file
+    };
+
+private:
+    void ReadStage(void);
+    void LexStage(void);
+    Batch *Take(SpscRing<Batch *> &ring);
+    void Give(SpscRing<Batch *> &ring, Batch *b);
+    bool Fetch(void);
+
+private:
+    const char *base;
+    const char *end;
+    std::unique_ptr<Batch[]> batches;
+    SpscRing<Batch *> freeRing;             // Parser -> reader
+    SpscRing<Batch *> readRing;             // reader -> lexer
+    SpscRing<Batch *> lexedRing;            // lexer -> Parser
+    std::atomic<bool> stop;
+    Batch *current;                         // the Batch the Parser is taking lines from
+    size_t index;                           // the next line in current
+    std::thread reader;
+    std::thread lexer;
+};
+
+//===============================================================================================
+
+#endif
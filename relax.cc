@@ -0,0 +1,417 @@
+//===============================================================================================
+// relax.cc -- This file contains the class implementation for branch relaxation and the final
+// resolution of label references.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-013   Initial version
+// 2026-10-16  ADCL   U-014   Record a Reloc for each Fixup that holds an address
+// 2026-10-16  ADCL   U-015   Add the origin to every final address
+// 2026-10-16  ADCL   U-016   Chain Fixups on undefined symbols; Relocs for external symbols
+// 2026-10-16  ADCL   U-017   Evaluate deferred expressions and EQU symbols
+// 2026-10-16  ADCL   U-017   A word Fixup out of range is an error, as a byte one is
+// 2026-10-16  ADCL   U-025   Relax() counts the slots it visits
+//
+//===============================================================================================
+
+#include "relax.hpp"
+#include "encoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+//-----------------------------------------------------------------------------------------------
+// A short slot can only be pushed out of range by a slot this close to it (a short branch
+// reaches 128 bytes back and 127 forward, plus the slot itself).
+//-----------------------------------------------------------------------------------------------
+static const int64_t SHORT_REACH = 130;
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::AddBranch(...) adds a slot for a branch at staging offset pos.  The Parser has already
+// written the 2 bytes of the short form there (with a placeholder displacement).  nearRow is the
+// REL16 row, if the instruction has one; fixedShort is set for `SHORT` branches.
+//-----------------------------------------------------------------------------------------------
+void Relaxer::AddBranch(uint32_t pos, const OpCodeEntry *shortRow, const OpCodeEntry *nearRow,
+        Symbol *sym, bool here, int64_t addend, uint32_t expr, bool fixedShort, SrcLoc loc)
+{
+    uint8_t nearSize = 0;
+    uint8_t op = shortRow->byteCode[0];
+
+    if (!fixedShort) {
+        if (nearRow) nearSize = nearRow->opcodeBytes + 2;
+        else if (op >= 0x70 && op <= 0x7f) nearSize = 5;
+    }
+
+    slots.push_back(Slot { pos, sym, addend, expr, shortRow, nearRow, loc, 2, nearSize, false,
+            here });
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::AddFixup(const Fixup&) adds a Fixup, and chains it onto its symbol if the symbol is
+// not defined yet.
+//-----------------------------------------------------------------------------------------------
+void Relaxer::AddFixup(const Fixup &f)
+{
+    fixups.push_back(f);
+
+    Symbol *sym = f.sym;
+    if (!sym || sym->IsDefined()) return;
+
+    if (!sym->Pending()) pending.push_back(sym);
+    fixups.back().next = sym->Pending();
+    sym->SetPending((uint32_t)fixups.size());
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Settled(uint32_t, uint32_t) returns true if there is no branch between the staging
+// offsets from and to, so that the distance between them is already final.
+//-----------------------------------------------------------------------------------------------
+bool Relaxer::Settled(uint32_t from, uint32_t to) const
+{
+    if (from > to) std::swap(from, to);
+
+    auto k = std::lower_bound(slots.begin(), slots.end(), from,
+            [](const Slot &s, uint32_t p) { return s.pos < p; });
+    return k == slots.end() || k->pos >= to;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Grow(size_t, uint32_t) and Relaxer::GrowthBefore(size_t) are the Fenwick tree: the
+// growth of slot i, and the total growth of slots [0..i).
+//-----------------------------------------------------------------------------------------------
+void Relaxer::Grow(size_t i, uint32_t delta)
+{
+    for (i ++; i < tree.size(); i += i & (~i + 1)) tree[i] += delta;
+}
+
+uint32_t Relaxer::GrowthBefore(size_t i) const
+{
+    uint32_t sum = 0;
+
+    for ( ; i > 0; i -= i & (~i + 1)) sum += tree[i];
+    return sum;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Final(uint32_t) returns the final offset of a staging offset: the offset plus the
+// growth of every slot that starts before it.  Address() adds the origin to that.
+//-----------------------------------------------------------------------------------------------
+int64_t Relaxer::Final(uint32_t pos) const
+{
+    size_t k = std::lower_bound(slots.begin(), slots.end(), pos,
+            [](const Slot &s, uint32_t p) { return s.pos < p; }) - slots.begin();
+
+    return (int64_t)pos + GrowthBefore(k);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Resolve(const Symbol*, int64_t&, int&, int) returns the final value of a symbol, and in
+// rel the number of section addresses in it (see ExprPool::Evaluate()).  A label's value is a
+// staging offset until Finish(); an EQU is a constant or an expression.  On failure, why says
+// what went wrong.
+//-----------------------------------------------------------------------------------------------
+bool Relaxer::Resolve(const Symbol *sym, int64_t &v, int &rel, int depth) const
+{
+    if (!sym->IsDefined()) {
+        why = "undefined symbol '" + std::string(names->Name(sym)) + "'";
+        return false;
+    }
+
+    if (sym->GetType() == Symbol::SYM_LABEL) {
+        v = Address((uint32_t)sym->Value());
+        rel = 1;
+        return true;
+    }
+
+    if (!sym->Expr()) {
+        v = sym->Value();
+        rel = 0;
+        return true;
+    }
+
+    if (depth == MAX_DEPTH) {
+        why = "'" + std::string(names->Name(sym)) + "' is defined in terms of itself";
+        return false;
+    }
+
+    return Eval(sym->Expr(), v, rel, depth + 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Eval(uint32_t, int64_t&, int&, int) evaluates a deferred expression with the final
+// addresses.
+//-----------------------------------------------------------------------------------------------
+bool Relaxer::Eval(uint32_t node, int64_t &v, int &rel, int depth) const
+{
+    auto leaf = [&](const ExprNode &n, int64_t &lv, int &lr) {
+        if (n.op == EX_HERE) {
+            lv = Address(n.pos) + n.value;
+            lr = 1;
+            return true;
+        }
+
+        if (!Resolve(n.sym, lv, lr, depth)) return false;
+        lv += n.value;
+        return true;
+    };
+
+    why = "division by zero";
+    return exprs.Evaluate(node, leaf, v, rel);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Target(const Slot&, int64_t&) works out the final address a branch goes to.
+//-----------------------------------------------------------------------------------------------
+bool Relaxer::Target(const Slot &s, int64_t &t) const
+{
+    int64_t v;
+    int rel;
+
+    t = s.addend;
+    if (s.here) t += Address(s.pos);
+    if (s.sym && !Resolve(s.sym, v, rel, 0)) return false;
+    if (s.sym) t += v;
+    if (s.expr && !Eval(s.expr, v, rel, 0)) return false;
+    if (s.expr) t += v;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Relax() settles the size of every slot with a worklist, as described in relax.hpp.
+//-----------------------------------------------------------------------------------------------
+void Relaxer::Relax(void)
+{
+    std::vector<uint32_t> work;
+
+    tree.assign(slots.size() + 1, 0);
+    work.reserve(slots.size());
+
+    for (size_t i = slots.size(); i -- > 0; ) {
+        if (slots[i].nearSize) {
+            slots[i].queued = true;
+            work.push_back((uint32_t)i);
+        }
+    }
+
+    while (!work.empty()) {
+        size_t i = work.back();
+        Slot &s = slots[i];
+
+        work.pop_back();
+        s.queued = false;
+        visits ++;
+
+        if (s.size != 2) continue;
+
+        uint32_t before = GrowthBefore(i);
+        int64_t at = origin + s.pos + before;
+
+        // -- an undefined symbol is external (or an error), and so is never in reach
+        int64_t target;
+
+        if (Target(s, target)) {
+            int64_t disp = target - (at + 2);
+            if (disp >= -128 && disp <= 127) continue;
+        }
+
+        Grow(i, s.nearSize - 2);
+        s.size = s.nearSize;
+        grown ++;
+
+        // -- only the short slots that could branch across this one need another look; the
+        //    growth before each neighbour is kept as the walk goes, rather than asked of the tree
+        auto requeue = [&](size_t j, uint32_t growth) {
+            Slot &n = slots[j];
+
+            if (std::abs(origin + n.pos + growth - at) > SHORT_REACH) return false;
+
+            if (n.size == 2 && n.nearSize && !n.queued) {
+                n.queued = true;
+                work.push_back((uint32_t)j);
+            }
+
+            return true;
+        };
+
+        uint32_t g = before;
+        for (size_t j = i; j -- > 0; ) {
+            g -= slots[j].size - 2;
+            if (!requeue(j, g)) break;
+        }
+
+        g = before + s.size - 2;
+        for (size_t j = i + 1; j < slots.size(); j ++) {
+            if (!requeue(j, g)) break;
+            g += slots[j].size - 2;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Encode(const Slot&, int64_t, uint8_t*) writes a settled branch at its final address
+// and returns its length, or 0 if a short branch cannot reach its target.
+//-----------------------------------------------------------------------------------------------
+size_t Relaxer::Encode(const Slot &s, int64_t address, uint8_t *out) const
+{
+    Operand ops[3];
+    int64_t target = 0;
+
+    Target(s, target);
+
+    ops[0].cls = OC_IMM16;
+    ops[0].value = target;
+
+    if (s.size == 2) return Encoder::Encode(s.shortRow, ops, (uint32_t)address, out);
+    if (s.nearRow) return Encoder::Encode(s.nearRow, ops, (uint32_t)address, out);
+
+    int64_t rel = target - (address + 5);
+
+    out[0] = s.shortRow->byteCode[0] ^ 0x01;
+    out[1] = 3;
+    out[2] = 0xe9;
+    Put(out + 3, rel, 2);
+    return 5;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Put(uint8_t*, int64_t, uint8_t) writes a little-endian field of 1 or 2 bytes.
+//-----------------------------------------------------------------------------------------------
+void Relaxer::Put(uint8_t *p, int64_t v, uint8_t size)
+{
+    p[0] = (uint8_t)v;
+    if (size == 2) p[1] = (uint8_t)(v >> 8);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Relaxer::Finish(Section&, int64_t, bool, const SymbolTable&, const Reporter&) relaxes the
+// branches, expands the section in place, and resolves every branch, fixup, and label, for a
+// section that is loaded at org.  A symbol that is still undefined is an external if externals
+// is set.  Errors (undefined symbols, short branches out of range, expressions that cannot be
+// evaluated) are passed to report with the location of the reference.
+//-----------------------------------------------------------------------------------------------
+void Relaxer::Finish(Section &sect, int64_t org, bool externals, const SymbolTable &symTab,
+        const Reporter &report)
+{
+    struct Late {
+        SrcLoc loc;
+        std::string msg;
+    };
+
+    std::vector<Late> late;
+
+    origin = org;
+    names = &symTab;
+    Relax();
+
+    // -- expand the section from the end, moving each run of fixed bytes once
+    uint32_t growth = GrowthBefore(slots.size());
+    uint32_t oldSize = (uint32_t)sect.Size();
+
+    sect.Reserve(growth);
+    uint8_t *base = sect.At(0);
+    uint32_t end = oldSize;
+
+    for (size_t i = slots.size(); i -- > 0; ) {
+        const Slot &s = slots[i];
+        uint32_t fixed = s.pos + 2;
+        uint32_t at = s.pos + growth - (s.size - 2);
+        int64_t target;
+
+        memmove(base + fixed + growth, base + fixed, end - fixed);
+        growth -= s.size - 2;
+        end = s.pos;
+
+        if (Target(s, target)) {
+            if (!Encode(s, origin + at, base + at)) {
+                late.push_back(Late { s.loc, "short jump out of range" });
+            }
+        } else if (!externals || !s.sym || s.sym->IsDefined()) {
+            late.push_back(Late { s.loc, why });
+        } else if (s.size == 2) {
+            late.push_back(Late { s.loc, "short jump to external symbol '"
+                    + std::string(symTab.Name(s.sym)) + "'" });
+        } else {
+            // -- the REL16 is the last field of both near forms
+            Encode(s, origin + at, base + at);
+            Put(base + at + s.size - 2, s.addend - 2, 2);
+            relocs.push_back(Reloc { at + s.size - 2u, s.addend - 2, s.sym, 2, true });
+        }
+    }
+
+    // -- the slots were done from the end; report in the order they were written
+    for (size_t i = late.size(); i -- > 0; ) report(late[i].loc, late[i].msg);
+
+    sect.Commit(base + oldSize + GrowthBefore(slots.size()));
+
+    // -- the other references to labels; those to undefined symbols are left on their chains
+    for (size_t i = 0; i < fixups.size(); i ++) {
+        const Fixup &f = fixups[i];
+        int64_t v = f.addend, x;
+        int rel = 0, r;
+
+        if (f.sym && !f.sym->IsDefined()) continue;
+
+        if ((f.sym && !Resolve(f.sym, x, r, 0)) || (f.expr && !Eval(f.expr, x, r, 0))) {
+            report(f.loc, why);
+            continue;
+        }
+
+        if (f.sym || f.expr) { v += x; rel += r; }
+        if (f.here) { v += Address(f.insn); rel ++; }
+        if (f.relative) { v -= Address(f.insn + f.insnLen); rel --; }
+
+        // -- a distance within the section is final; an address moves with the section
+        if (externals && rel != 0 && rel != 1) {
+            report(f.loc, "expression is not relocatable");
+        } else if (rel == 1) {
+            relocs.push_back(Reloc { (uint32_t)Final(f.field), v, NULL, f.size, false });
+        }
+
+        // -- a field holds either a signed or an unsigned value of its width
+        if ((f.size == 1 && (v < -128 || v > 255)) || (f.size == 2 && (v < -32768 || v > 65535))) {
+            report(f.loc, "value out of range");
+        }
+
+        Put(base + Final(f.field), v, f.size);
+    }
+
+    // -- the only references not resolved here
+    for (size_t i = 0; i < pending.size(); i ++) {
+        Symbol *sym = pending[i];
+
+        if (sym->IsDefined()) continue;
+
+        late.clear();
+
+        for (uint32_t k = sym->Pending(); k; k = fixups[k - 1].next) {
+            const Fixup &f = fixups[k - 1];
+            int64_t v = f.addend;
+
+            if (!externals) {
+                late.push_back(Late { f.loc,
+                        "undefined symbol '" + std::string(symTab.Name(sym)) + "'" });
+                continue;
+            }
+
+            if (f.relative) v -= Final(f.insn + f.insnLen) - Final(f.field);
+
+            Put(base + Final(f.field), v, f.size);
+            relocs.push_back(Reloc { (uint32_t)Final(f.field), v, sym, f.size, f.relative });
+        }
+
+        // -- the chain runs from the last reference back to the first
+        for (size_t j = late.size(); j -- > 0; ) report(late[j].loc, late[j].msg);
+    }
+
+    // -- the branches to externals were found from the end
+    std::sort(relocs.begin(), relocs.end(),
+            [](const Reloc &a, const Reloc &b) { return a.offset < b.offset; });
+
+    // -- last, since everything above needs the staging values
+    for (size_t i = 0; i < labels.size(); i ++) {
+        labels[i]->SetValue(Address((uint32_t)labels[i]->Value()));
+    }
+}
+
+//===============================================================================================
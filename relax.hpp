@@ -0,0 +1,183 @@
+//===============================================================================================
+// relax.hpp -- This file contains the class definition for branch relaxation and the final
+// resolution of label references.
+//
+// While a file is parsed, its code is laid out as if every relative branch were short: each
+// branch is given a 2-byte slot in the section and remembered.  Everything between 2 branch
+// slots is a fragment of fixed bytes, so the address of any byte at the end is just its offset
+// during the parse (its "staging" offset) plus however much the slots before it have grown.
+// That growth is kept in a Fenwick tree indexed by slot, so finding the final address of any
+// offset is O(log n) and growing a slot is O(log n) -- nothing is ever re-walked or shifted
+// until the very end.
+//
+// Relaxation starts with every slot queued.  A slot whose target is out of the short range is
+// grown to its near form, and that can only push out of range the short slots that branch
+// across it -- which, being short, are all within about 128 bytes of it.  Those are the only
+// ones queued again.  Slots only ever grow, so this converges.
+//
+// A branch's near form is the REL16 row of the instruction when there is one (JMP).  A Jcc has
+// no REL16 form on the 8086, so its near form is the inverted Jcc around a near JMP: `JNE $+5`
+// `JMP target` (5 bytes).  LOOP and JCXZ have no near form and are reported if out of range, as
+// are branches written `SHORT`.
+//
+// Once the slots are settled, the section is expanded in place from the end (so no second copy
+// is needed), the branches are encoded, the labels are given their final values, and the other
+// references to labels (Fixups) are patched.  Every final address includes the origin given
+// with ORG (0 unless one was), since that is where the section will be loaded.  A Fixup that
+// holds an address (rather than a distance) also becomes a Reloc, since the section is only
+// placed by the linker.
+//
+// An expression the Parser could not fold (see expr.hpp) is evaluated here too, as is an EQU
+// that was defined by one -- by then every label has its final address.  For an object file, its
+// value has to be a constant or a single address plus a constant; anything else cannot be
+// expressed as a Reloc.
+//
+// A Fixup for a symbol that is not defined yet is also chained onto the Symbol (Symbol::Pending()
+// and Fixup::next).  Defining the label releases the chain -- its Fixups are then resolved with
+// all the others at the end, as the label's address can still move until then.  Whatever is
+// still chained at the end is the only thing left unresolved: an error, or when externals are
+// allowed (an object file), a Reloc against the symbol for the linker to fill in.  A branch to an
+// external is given its near form, since the linker can only patch a REL16.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-013   Initial version
+// 2026-10-16  ADCL   U-014   Addresses are recorded as Relocs for the object file
+// 2026-10-16  ADCL   U-015   Final addresses are relative to the ORG
+// 2026-10-16  ADCL   U-016   Fixups for undefined symbols are chained on the Symbol; externals
+// 2026-10-16  ADCL   U-017   Fixups may hold a deferred expression; EQU symbols are resolved here
+// 2026-10-16  ADCL   U-025   Count the slots relaxation visits (Visits())
+//
+//===============================================================================================
+
+#ifndef __RELAX_HPP__
+#define __RELAX_HPP__
+
+#ifndef __cplusplus
+#error The file 'relax.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include "OpCodeTable.h"
+#include "expr.hpp"
+#include "section.hpp"
+#include "srcfile.hpp"
+#include "symtab.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// A Fixup is a field of an instruction whose value depends on where a label (or the instruction
+// itself, for `$`) ends up.  The value is the symbol's final address (or the instruction's, if
+// here is set) plus the addend, plus the value of expr if the expression had to be kept; for a
+// relative field the final address of the end of the instruction is subtracted.  Offsets are
+// staging offsets.
+//-----------------------------------------------------------------------------------------------
+struct Fixup {
+    uint32_t field;                 // where the field is
+    uint32_t insn;                  // where the instruction starts
+    Symbol *sym;                    // the symbol, or NULL
+    int64_t addend;
+    uint32_t expr;                  // an ExprNode, or 0
+    SrcLoc loc;                     // the reference, for errors
+    uint32_t next;                  // the previous Fixup for the same undefined symbol (+ 1)
+    uint8_t insnLen;
+    uint8_t size;                   // 1 or 2 bytes
+    bool relative;
+    bool here;
+};
+
+//-----------------------------------------------------------------------------------------------
+// A Reloc is a field for the linker to fill in: the address of the section (when sym is NULL)
+// or of an external symbol, plus addend; for a relative Reloc, less the address of the field.
+// The field already holds the addend.
+//-----------------------------------------------------------------------------------------------
+struct Reloc {
+    uint32_t offset;                // where the field is, in the final section
+    int64_t addend;
+    Symbol *sym;                    // the external symbol, or NULL for the section
+    uint8_t size;                   // 1 or 2 bytes
+    bool relative;
+};
+
+//-----------------------------------------------------------------------------------------------
+// The Relaxer class.  The Parser calls AddBranch() and AddFixup() as it encodes, AddLabel() as
+// labels are defined, and Finish() once at the end of the file.
+//-----------------------------------------------------------------------------------------------
+class Relaxer {
+public:
+    typedef std::function<void (SrcLoc, const std::string &)> Reporter;
+
+public:
+    Relaxer(const ExprPool &e) : exprs(e), names(NULL), origin(0), grown(0), visits(0) {};
+    virtual ~Relaxer() {};
+
+private:
+    Relaxer(const Relaxer &);
+    Relaxer &operator=(const Relaxer &);
+
+public:
+    void AddBranch(uint32_t pos, const OpCodeEntry *shortRow, const OpCodeEntry *nearRow,
+            Symbol *sym, bool here, int64_t addend, uint32_t expr, bool fixedShort, SrcLoc loc);
+    void AddFixup(const Fixup &f);
+    void AddLabel(Symbol *sym) { labels.push_back(sym); Defined(sym); };
+    void Defined(Symbol *sym) { sym->SetPending(0); };
+    void Finish(Section &sect, int64_t org, bool externals, const SymbolTable &symTab,
+            const Reporter &report);
+    bool Settled(uint32_t from, uint32_t to) const;
+
+    const std::vector<Symbol *> &Labels(void) const { return labels; };
+    const std::vector<Reloc> &Relocs(void) const { return relocs; };
+    size_t Branches(void) const { return slots.size(); };
+    size_t Grown(void) const { return grown; };
+    size_t Visits(void) const { return visits; };
+
+private:
+    struct Slot {
+        uint32_t pos;               // the staging offset of the 2-byte slot
+        Symbol *sym;
+        int64_t addend;
+        uint32_t expr;              // an ExprNode, or 0
+        const OpCodeEntry *shortRow;
+        const OpCodeEntry *nearRow; // NULL for a Jcc, which uses the inverted form
+        SrcLoc loc;
+        uint8_t size;               // the current size: 2, or the near size
+        uint8_t nearSize;           // 0 if there is no near form
+        bool queued;
+        bool here;
+    };
+
+private:
+    void Relax(void);
+    int64_t Final(uint32_t pos) const;
+    int64_t Address(uint32_t pos) const { return origin + Final(pos); };
+    bool Resolve(const Symbol *sym, int64_t &v, int &rel, int depth) const;
+    bool Eval(uint32_t node, int64_t &v, int &rel, int depth) const;
+    bool Target(const Slot &s, int64_t &t) const;
+    void Grow(size_t i, uint32_t delta);
+    uint32_t GrowthBefore(size_t i) const;
+    size_t Encode(const Slot &s, int64_t address, uint8_t *out) const;
+    static void Put(uint8_t *p, int64_t v, uint8_t size);
+
+private:
+    static const int MAX_DEPTH = 64;  // how deeply EQUs may refer to each other
+
+    const ExprPool &exprs;
+    const SymbolTable *names;       // during Finish()
+    mutable std::string why;        // why the last Resolve() or Eval() failed
+    std::vector<Slot> slots;
+    std::vector<uint32_t> tree;     // the Fenwick tree of slot growth
+    std::vector<Fixup> fixups;
+    std::vector<Symbol *> labels;
+    std::vector<Symbol *> pending;  // every symbol that had a Fixup chained while undefined
+    std::vector<Reloc> relocs;
+    int64_t origin;
+    size_t grown;
+    size_t visits;                  // slots taken off the work list by Relax()
+};
+
+//===============================================================================================
+
+#endif
@@ -0,0 +1,134 @@
+//===============================================================================================
+// ring.hpp -- This file contains the class definition for a lock-free single-producer,
+// single-consumer ring buffer.
+//
+// The pipelined assembly passes work from one stage's thread to the next through these rings.
+// Exactly one thread pushes and exactly one other thread pops, so no lock and no compare-and-swap
+// is needed: the producer owns tail and the consumer owns head, and each only reads the other's
+// index (with acquire, after the release that published it).  Each keeps a cached copy of the
+// other's index, so that it only has to touch the other's cache line when the ring looks full
+// (or empty).  The ring holds a fixed number of slots; a full ring is what makes a fast stage
+// wait for a slow one, and so bounds the memory in flight.
+//
+// TryPush() and TryPop() never block.  A stage that has to wait uses a Backoff: it spins
+// briefly, then yields, then sleeps for longer and longer (up to a millisecond), so that a stage
+// waiting for a long time (the reader of a file whose include is being read) does not take a
+// core from the others.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-024   Initial version
+//
+//===============================================================================================
+
+#ifndef __RING_HPP__
+#define __RING_HPP__
+
+#ifndef __cplusplus
+#error The file 'ring.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// The SpscRing class.  The capacity is rounded up to a power of 2.
+//-----------------------------------------------------------------------------------------------
+template <typename T>
+class SpscRing {
+public:
+    SpscRing(size_t capacity) : head(0), tail(0), cachedHead(0), cachedTail(0) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+
+        slots.reset(new T[n]);
+        mask = n - 1;
+    };
+
+private:
+    SpscRing(const SpscRing &);
+    SpscRing &operator=(const SpscRing &);
+
+public:
+    // -- called only by the producer
+    bool TryPush(T &&v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) return false;
+        }
+
+        slots[t & mask] = std::move(v);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    };
+
+    // -- called only by the consumer
+    bool TryPop(T &v) {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+
+        v = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    };
+
+private:
+    alignas(64) std::atomic<size_t> head;   // the next slot to pop; written by the consumer
+    alignas(64) std::atomic<size_t> tail;   // the next slot to push; written by the producer
+    alignas(64) size_t cachedHead;          // the producer's copy of head
+    alignas(64) size_t cachedTail;          // the consumer's copy of tail
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+};
+
+//-----------------------------------------------------------------------------------------------
+// A Backoff is one wait for a ring: Pause() is called each time the ring is still full (or
+// empty), and waits a little longer each time.
+//-----------------------------------------------------------------------------------------------
+class Backoff {
+public:
+    Backoff(void) : count(0), sleep(MIN_SLEEP) {};
+
+public:
+    void Pause(void) {
+        if (count < SPINS) {
+#ifdef __SSE2__
+            _mm_pause();
+#endif
+        } else if (count < SPINS + YIELDS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(sleep));
+            if (sleep < MAX_SLEEP) sleep *= 2;
+        }
+
+        count ++;
+    };
+
+private:
+    static const unsigned SPINS = 64;
+    static const unsigned YIELDS = 64;
+    static const unsigned MIN_SLEEP = 16;          // microseconds
+    static const unsigned MAX_SLEEP = 1024;
+
+    unsigned count;
+    unsigned sleep;
+};
+
+//===============================================================================================
+
+#endif
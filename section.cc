@@ -0,0 +1,65 @@
+//===============================================================================================
+// section.cc -- This file contains the class implementation for an output section.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-012   Initial version
+//
+//===============================================================================================
+
+#include "section.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+//-----------------------------------------------------------------------------------------------
+// Section::Section(const std::string&) creates an empty section; the buffer is allocated on the
+// first write.
+//-----------------------------------------------------------------------------------------------
+Section::Section(const std::string &n) : name(n), data(NULL), len(0), cap(0)
+{
+}
+
+Section::~Section()
+{
+    free(data);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Section::Grow(size_t) makes room for at least n more bytes, doubling the buffer.  It throws
+// std::bad_alloc if it cannot.
+//-----------------------------------------------------------------------------------------------
+void Section::Grow(size_t n)
+{
+    size_t newCap = (cap ? cap : INITIAL_SIZE);
+
+    while (newCap - len < n) newCap *= 2;
+
+    uint8_t *p = static_cast<uint8_t *>(realloc(data, newCap));
+    if (!p) throw std::bad_alloc();
+
+    data = p;
+    cap = newCap;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Section::Append(const void*, size_t) and Section::Fill(uint8_t, size_t) add data and padding.
+//-----------------------------------------------------------------------------------------------
+void Section::Append(const void *bytes, size_t n)
+{
+    uint8_t *p = Reserve(n);
+
+    memcpy(p, bytes, n);
+    len += n;
+}
+
+void Section::Fill(uint8_t byte, size_t n)
+{
+    uint8_t *p = Reserve(n);
+
+    memset(p, byte, n);
+    len += n;
+}
+
+//===============================================================================================
@@ -0,0 +1,68 @@
+//===============================================================================================
+// section.hpp -- This file contains the class definition for an output section.
+//
+// A Section is the bytes of assembled output for one section of the object file, held in a
+// single contiguous buffer.  The buffer grows geometrically, so appending n bytes is amortized
+// O(n) and, once a file has been assembled, there are only O(log size) allocations behind it.
+//
+// Instructions are written in place: the encoder asks Reserve() for room for the longest
+// possible instruction, writes the bytes directly into the buffer, and calls Commit() with the
+// end of what it wrote.  Nothing is allocated or copied per instruction.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-012   Initial version
+//
+//===============================================================================================
+
+#ifndef __SECTION_HPP__
+#define __SECTION_HPP__
+
+#ifndef __cplusplus
+#error The file 'section.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+// The Section class.  A pointer from Reserve() is only good until the next Reserve() or
+// Append(), since either may move the buffer; offsets (Size(), At()) stay good.
+//-----------------------------------------------------------------------------------------------
+class Section {
+public:
+    Section(const std::string &n);
+    virtual ~Section();
+
+private:
+    Section(const Section &);
+    Section &operator=(const Section &);
+
+public:
+    uint8_t *Reserve(size_t n) { if (cap - len < n) Grow(n); return data + len; };
+    void Commit(const uint8_t *end) { len = end - data; };
+    void Append(const void *bytes, size_t n);
+    void Fill(uint8_t byte, size_t n);
+
+    const std::string &Name(void) const { return name; };
+    const uint8_t *Data(void) const { return data; };
+    uint8_t *At(size_t offset) { return data + offset; };
+    size_t Size(void) const { return len; };
+    void Clear(void) { len = 0; };
+
+private:
+    void Grow(size_t n);
+
+private:
+    static const size_t INITIAL_SIZE = 4096;
+
+    std::string name;
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+};
+
+//===============================================================================================
+
+#endif
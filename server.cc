@@ -0,0 +1,339 @@
+//===============================================================================================
+// server.cc -- This file contains the class implementation for the assembler server.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-021   Initial version
+// 2026-10-16  ADCL   U-021   Serve() only removes a stale socket, never another kind of file
+// 2026-10-16  ADCL   U-021   Requests are served by a fixed pool of threads rather than one each
+//
+//===============================================================================================
+
+#include "server.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+//-----------------------------------------------------------------------------------------------
+// These bound what a message may claim to hold, so that a bad one cannot make us allocate
+// without limit.
+//-----------------------------------------------------------------------------------------------
+static const uint32_t MAX_STRINGS = 65536;
+static const uint32_t MAX_LENGTH = 64 * 1024 * 1024;
+
+//-----------------------------------------------------------------------------------------------
+// ReadAll() and WriteAll() move exactly len bytes, or return false.
+//-----------------------------------------------------------------------------------------------
+static bool ReadAll(int fd, void *buf, size_t len)
+{
+    char *p = static_cast<char *>(buf);
+
+    while (len) {
+        ssize_t n = read(fd, p, len);
+
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+
+        p += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+static bool WriteAll(int fd, const void *buf, size_t len)
+{
+    const char *p = static_cast<const char *>(buf);
+
+    while (len) {
+        ssize_t n = write(fd, p, len);
+
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+
+        p += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Send() and Receive() move one message.
+//-----------------------------------------------------------------------------------------------
+static bool Send(int fd, const std::vector<std::string> &msg)
+{
+    std::string buf;
+    uint32_t n = (uint32_t)msg.size();
+
+    buf.append(reinterpret_cast<const char *>(&n), sizeof(n));
+
+    for (size_t i = 0; i < msg.size(); i ++) {
+        n = (uint32_t)msg[i].size();
+        buf.append(reinterpret_cast<const char *>(&n), sizeof(n));
+        buf.append(msg[i]);
+    }
+
+    return WriteAll(fd, buf.data(), buf.size());
+}
+
+static bool Receive(int fd, std::vector<std::string> &msg)
+{
+    uint32_t count, len;
+
+    if (!ReadAll(fd, &count, sizeof(count)) || count > MAX_STRINGS) return false;
+
+    msg.resize(count);
+
+    for (uint32_t i = 0; i < count; i ++) {
+        if (!ReadAll(fd, &len, sizeof(len)) || len > MAX_LENGTH) return false;
+
+        msg[i].resize(len);
+        if (len && !ReadAll(fd, &msg[i][0], len)) return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Address() fills in the socket address for path, or returns false if it is too long.
+//-----------------------------------------------------------------------------------------------
+static bool Address(const std::string &path, struct sockaddr_un &addr)
+{
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+
+    memcpy(addr.sun_path, path.data(), path.size());
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Connect() returns a socket connected to the server at path, or -1.
+//-----------------------------------------------------------------------------------------------
+static int Connect(const std::string &path)
+{
+    struct sockaddr_un addr;
+
+    if (!Address(path, addr)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Handle() serves one connection.  Anything the handler throws is a failed request, not a failed
+// server.
+//-----------------------------------------------------------------------------------------------
+static void Handle(int fd, const AssemblyServer::Handler &handler)
+{
+    std::vector<std::string> msg;
+    std::vector<std::string> outputs;
+    std::ostringstream diag;
+    int status;
+
+    if (!Receive(fd, msg) || msg.empty()) return;
+
+    try {
+        std::vector<std::string> args(msg.begin() + 1, msg.end());
+
+        status = handler(args, msg[0], diag, outputs);
+    } catch (std::exception &e) {
+        diag << "as-cent: " << e.what() << '\n';
+        status = 1;
+    }
+
+    msg.clear();
+    msg.push_back(std::to_string(status));
+    msg.push_back(diag.str());
+    msg.insert(msg.end(), outputs.begin(), outputs.end());
+
+    Send(fd, msg);
+}
+
+//-----------------------------------------------------------------------------------------------
+// A HandlerPool is a fixed number of threads serving the connections accepted, in turn, from a
+// queue of at most as many again.  The threads are never stopped: Serve() only returns if it
+// could not listen, before the pool exists, and the process exits after that.
+//-----------------------------------------------------------------------------------------------
+class HandlerPool {
+public:
+    HandlerPool(const AssemblyServer::Handler &h) : handler(h) {
+        size_t n = std::max(MIN_HANDLERS, (size_t)std::thread::hardware_concurrency());
+
+        limit = n;
+        for (size_t i = 0; i < n; i ++) std::thread(&HandlerPool::Run, this).detach();
+    };
+
+private:
+    HandlerPool(const HandlerPool &);
+    HandlerPool &operator=(const HandlerPool &);
+
+public:
+    // -- waits until the queue has room for one more connection
+    void WaitForRoom(void) {
+        std::unique_lock<std::mutex> lock(mutex);
+        roomy.wait(lock, [this]() { return queue.size() < limit; });
+    };
+
+    void Add(int fd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(fd);
+        ready.notify_one();
+    };
+
+private:
+    void Run(void) {
+        for (;;) {
+            int fd;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this]() { return !queue.empty(); });
+
+                fd = queue.front();
+                queue.pop_front();
+                roomy.notify_one();
+            }
+
+            Handle(fd, handler);
+            close(fd);
+        }
+    };
+
+private:
+    static const size_t MIN_HANDLERS = 4;
+
+    AssemblyServer::Handler handler;
+    size_t limit;                           // the threads, and the connections that may wait
+    std::mutex mutex;
+    std::condition_variable ready;          // the queue is not empty
+    std::condition_variable roomy;          // the queue is not full
+    std::deque<int> queue;
+};
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyServer::Serve(const std::string&, Handler) listens on path and runs handler for each
+// request, on one of the HandlerPool's threads.  A socket left at path by a server that has gone
+// is replaced; one with a server still listening is not, and neither is anything at path that is
+// not a socket.
+//-----------------------------------------------------------------------------------------------
+int AssemblyServer::Serve(const std::string &path, Handler handler)
+{
+    struct sockaddr_un addr;
+    int fd;
+
+    if (!Address(path, addr)) {
+        std::cerr << "as-cent: invalid socket path '" << path << "'" << std::endl;
+        return 1;
+    }
+
+    if ((fd = Connect(path)) >= 0) {
+        close(fd);
+        std::cerr << "as-cent: a server is already listening on " << path << std::endl;
+        return 1;
+    }
+
+    // -- only a socket is left over from a server; anything else at path is not ours to remove
+    struct stat st;
+
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << "as-cent: " << path << " exists and is not a socket" << std::endl;
+            return 1;
+        }
+
+        unlink(path.c_str());
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0
+            || listen(fd, SOMAXCONN) < 0) {
+        std::cerr << "as-cent: unable to listen on " << path << ": " << strerror(errno)
+                << std::endl;
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    // -- a client that goes away must not take the server with it
+    signal(SIGPIPE, SIG_IGN);
+
+    HandlerPool pool(handler);
+
+    for (;;) {
+        // -- with every handler busy and the queue full, further clients wait in the backlog
+        pool.WaitForRoom();
+
+        int c = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+
+        if (c < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+
+            // -- out of descriptors: wait for some of the requests being served to finish
+            if (errno == EMFILE || errno == ENFILE) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+
+            std::cerr << "as-cent: unable to accept on " << path << ": " << strerror(errno)
+                    << std::endl;
+            close(fd);
+            return 1;
+        }
+
+        pool.Add(c);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// AssemblyServer::Call(...) sends a request to the server at path and waits for the reply.
+//-----------------------------------------------------------------------------------------------
+bool AssemblyServer::Call(const std::string &path, const std::string &cwd,
+        const std::vector<std::string> &args, int &status, std::string &diag,
+        std::vector<std::string> &outputs)
+{
+    std::vector<std::string> msg(1, cwd);
+    int fd = Connect(path);
+
+    if (fd < 0) return false;
+
+    signal(SIGPIPE, SIG_IGN);
+    msg.insert(msg.end(), args.begin(), args.end());
+
+    bool ok = Send(fd, msg) && Receive(fd, msg) && msg.size() >= 2;
+    close(fd);
+
+    if (!ok) return false;
+
+    status = atoi(msg[0].c_str());
+    diag = msg[1];
+    outputs.assign(msg.begin() + 2, msg.end());
+
+    return true;
+}
+
+//===============================================================================================
@@ -0,0 +1,67 @@
+//===============================================================================================
+// server.hpp -- This file contains the class definition for the assembler server.
+//
+// Most of what an assembler process does before it reads its first line is the same every time:
+// it builds the mnemonic hash and the OpCodeView for the default ISA, and it maps and reads the
+// include files that every source in a project shares.  A build that runs as-cent thousands of
+// times pays for that thousands of times.
+//
+// With `-S socket`, as-cent instead stays running and listens on a Unix domain socket.  Each
+// connection is one invocation: the client sends its working directory and its arguments, the
+// server assembles exactly as a process started with those arguments in that directory would,
+// and sends back the exit status, the diagnostics and the output files written.  Everything the
+// process keeps -- the opcode tables and views, the source file registry, and the include cache
+// -- stays warm from one request to the next.  Connections are served by a fixed pool of threads
+// (one per core, and at least 4), so unrelated requests run at the same time; as many more may
+// wait in a queue, and beyond that they wait unaccepted in the socket's backlog.
+//
+// A client is as-cent started with `-s socket` (or with AS_CENT_SERVER set in the environment).
+// It sends everything else on its command line to the server; if there is no server listening,
+// it simply assembles the files itself.
+//
+// A message, in either direction, is a count and then that many strings, each a length and its
+// bytes; the numbers are 32-bit, in the host's byte order, since both ends are on one machine.
+// A request is the working directory then the arguments; a reply is the exit status (in
+// decimal), the diagnostics, and then the path of each output file.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-021   Initial version
+// 2026-10-16  ADCL   U-021   The requests served at once are bounded by a pool of threads
+//
+//===============================================================================================
+
+#ifndef __SERVER_HPP__
+#define __SERVER_HPP__
+
+#ifndef __cplusplus
+#error The file 'server.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The AssemblyServer class has no state.  Serve() runs handler for each request and only returns
+// (with 1, after writing the reason to std::cerr) if it cannot listen.  The handler writes its
+// diagnostics to diag, adds the outputs it writes to outputs, and returns the exit status; it
+// may be called from many threads at once.  Call() returns false if there is no server at path
+// (or it went away before replying).
+//-----------------------------------------------------------------------------------------------
+class AssemblyServer {
+public:
+    typedef std::function<int (const std::vector<std::string> &args, const std::string &cwd,
+            std::ostream &diag, std::vector<std::string> &outputs)> Handler;
+
+public:
+    static int Serve(const std::string &path, Handler handler);
+    static bool Call(const std::string &path, const std::string &cwd,
+            const std::vector<std::string> &args, int &status, std::string &diag,
+            std::vector<std::string> &outputs);
+};
+
+//===============================================================================================
+
+#endif
@@ -0,0 +1,34 @@
+//===============================================================================================
+// srcfile.cc -- This file contains the implementation of the source file registry.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-021   A registry for each FileStack rather than one for the process
+//
+//===============================================================================================
+
+#include "srcfile.hpp"
+
+#include <stdexcept>
+
+//-----------------------------------------------------------------------------------------------
+// SourceFiles::Register(const std::string&) returns the id for name, registering it if needed.
+//-----------------------------------------------------------------------------------------------
+FileId SourceFiles::Register(const std::string &name)
+{
+    if (name == "") return 0;
+
+    std::unordered_map<std::string, FileId>::iterator i = ids.find(name);
+
+    if (i != ids.end()) return i->second;
+    if (names.size() > 0xffff) throw std::length_error("Too many source files");
+
+    FileId id = (FileId)names.size();
+    names.push_back(name);
+    ids[name] = id;
+
+    return id;
+}
+
+//===============================================================================================
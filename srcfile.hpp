@@ -0,0 +1,64 @@
+//===============================================================================================
+// srcfile.hpp -- This file contains the registry of source file names.
+//
+// Every file that is opened is registered here once and is thereafter known by a small FileId.
+// Anything that needs to remember where something came from (a symbol, a diagnostic, debug
+// information) keeps a SrcLoc -- the FileId and a line number -- rather than a copy of the file
+// name.  FileId 0 is reserved for "no file" (built-in symbols and stdin).
+//
+// Each FileStack (and so each Parser) has a registry of its own, and an id only means something
+// to the Parser that registered it.  Nothing that outlives a Parser keeps a FileId, so a server
+// that assembles for as long as it runs never runs out of them, and the registry needs no lock:
+// files are only opened on the Parser's own thread.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-021   A registry for each FileStack rather than one for the process
+//
+//===============================================================================================
+
+#ifndef __SRCFILE_HPP__
+#define __SRCFILE_HPP__
+
+#ifndef __cplusplus
+#error The file 'srcfile.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef uint16_t FileId;
+
+//-----------------------------------------------------------------------------------------------
+// A SrcLoc is a location in the source; it is 8 bytes.
+//-----------------------------------------------------------------------------------------------
+struct SrcLoc {
+    FileId file;
+    uint32_t line;
+};
+
+//-----------------------------------------------------------------------------------------------
+// The SourceFiles class.  Register() returns the existing id if the name has been registered
+// before.  It throws std::length_error if more than 65535 distinct files are registered.
+//-----------------------------------------------------------------------------------------------
+class SourceFiles {
+public:
+    SourceFiles(void) : names(1, "") {};
+    virtual ~SourceFiles() {};
+
+public:
+    FileId Register(const std::string &name);
+    std::string Name(FileId id) const { return (id < names.size() ? names[id] : std::string()); };
+    size_t Count(void) const { return names.size(); };
+
+private:
+    std::vector<std::string> names;
+    std::unordered_map<std::string, FileId> ids;
+};
+
+//===============================================================================================
+
+#endif
@@ -0,0 +1,194 @@
+//===============================================================================================
+// stats.cc -- This file contains the class implementation for the counters and timers kept for
+// an assembly.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-025   Initial version
+// 2026-10-16  ADCL   U-021   The lines read are kept by file name
+//
+//===============================================================================================
+
+#include "stats.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <ios>
+
+#include <unistd.h>
+#include <sys/resource.h>
+
+//-----------------------------------------------------------------------------------------------
+// FileName() is the name to show for a file; stdin has none.
+//-----------------------------------------------------------------------------------------------
+static std::string FileName(const std::string &name)
+{
+    return (name == "" ? "(stdin)" : name);
+}
+
+//-----------------------------------------------------------------------------------------------
+// Json() writes s as a JSON string.
+//-----------------------------------------------------------------------------------------------
+static void Json(std::ostream &out, const std::string &s)
+{
+    out << '"';
+
+    for (size_t i = 0; i < s.size(); i ++) {
+        unsigned char c = s[i];
+
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out << buf;
+        } else out << c;
+    }
+
+    out << '"';
+}
+
+//-----------------------------------------------------------------------------------------------
+// Micros() is the time from origin to t, in microseconds, as the trace events give it.
+//-----------------------------------------------------------------------------------------------
+static double Micros(Stats::Clock::time_point origin, Stats::Clock::time_point t)
+{
+    return std::chrono::duration<double, std::micro>(t - origin).count();
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stats::Thread() is a small number for the calling thread, the same for as long as it runs.
+//-----------------------------------------------------------------------------------------------
+unsigned Stats::Thread(void)
+{
+    static std::atomic<unsigned> threads(0);
+    thread_local unsigned number = ++ threads;
+
+    return number;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stats::PeakMemory() is the most memory the process has had resident, in KiB.
+//-----------------------------------------------------------------------------------------------
+long Stats::PeakMemory(void)
+{
+    struct rusage ru;
+
+    if (getrusage(RUSAGE_SELF, &ru) < 0) return 0;
+    return ru.ru_maxrss;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stats::Print(std::ostream&, const std::string&) writes the counters, and the time spent in
+// each stage (the Spans with the same name added together, in the order they first ran), for the
+// Job that assembled name.  A stage run within another (lexing ahead, within the parse) is in the
+// time of both.
+//-----------------------------------------------------------------------------------------------
+void Stats::Print(std::ostream &out, const std::string &name) const
+{
+    std::vector<std::pair<const char *, double> > stages;
+    char buf[160];
+
+    for (size_t i = 0; i < spans.size(); i ++) {
+        double ms = std::chrono::duration<double, std::milli>(spans[i].end
+                - spans[i].start).count();
+        size_t s = 0;
+
+        while (s < stages.size() && std::string(stages[s].first) != spans[i].name) s ++;
+
+        if (s == stages.size()) stages.push_back(std::make_pair(spans[i].name, 0.0));
+        stages[s].second += ms;
+    }
+
+    out << "as-cent: stats: " << FileName(name) << '\n';
+
+    for (size_t s = 0; s < stages.size(); s ++) {
+        snprintf(buf, sizeof(buf), "    %-12s %12.3f ms\n", stages[s].first, stages[s].second);
+        out << buf;
+    }
+
+    std::map<std::string, uint64_t>::const_iterator i;
+
+    for (i = lines.begin(); i != lines.end(); i ++) {
+        snprintf(buf, sizeof(buf), "    %-12s %12llu  ", "lines", (unsigned long long)i->second);
+        out << buf << FileName(i->first) << '\n';
+    }
+
+    snprintf(buf, sizeof(buf), "    %-12s %12llu pushed, %llu popped\n", "includes",
+            (unsigned long long)pushes, (unsigned long long)pops);
+    out << buf;
+
+    snprintf(buf, sizeof(buf), "    %-12s %12llu\n", "tokens", (unsigned long long)tokens);
+    out << buf;
+
+    snprintf(buf, sizeof(buf), "    %-12s %12llu lookups, %.1f%% hits\n", "symbols",
+            (unsigned long long)lookups, (lookups ? 100.0 * hits / lookups : 0.0));
+    out << buf;
+
+    snprintf(buf, sizeof(buf), "    %-12s %12llu instructions, %.2f candidate rows each\n",
+            "opcodes", (unsigned long long)instructions,
+            (instructions ? (double)candidates / instructions : 0.0));
+    out << buf;
+
+    snprintf(buf, sizeof(buf), "    %-12s %12llu branches, %llu grown, %llu visits\n", "relaxation",
+            (unsigned long long)branches, (unsigned long long)grown, (unsigned long long)visits);
+    out << buf;
+
+    snprintf(buf, sizeof(buf), "    %-12s %12llu\n", "bytes", (unsigned long long)bytes);
+    out << buf;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Stats::Trace(...) writes the Spans of jobs (which assembled names) as Chrome trace-event JSON,
+// with times from origin.  Each Span is a complete ("X") event on its thread.  Each Job is one
+// more, around its Spans on the thread it started on, with its counters as the arguments.  A Job
+// that has no Spans (it was never started) has no events.
+//-----------------------------------------------------------------------------------------------
+void Stats::Trace(std::ostream &out, Clock::time_point origin,
+        const std::vector<const Stats *> &jobs, const std::vector<std::string> &names)
+{
+    const char *sep = "\n";
+    long pid = (long)getpid();
+
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\"traceEvents\":[";
+
+    for (size_t j = 0; j < jobs.size(); j ++) {
+        const Stats &s = *jobs[j];
+
+        if (s.spans.empty()) continue;
+
+        Clock::time_point start = s.spans[0].start, end = s.spans[0].end;
+        unsigned thread = s.spans[0].thread;
+
+        for (size_t i = 0; i < s.spans.size(); i ++) {
+            if (s.spans[i].thread != thread) continue;
+            if (s.spans[i].start < start) start = s.spans[i].start;
+            if (s.spans[i].end > end) end = s.spans[i].end;
+        }
+
+        out << sep << "{\"name\":";
+        Json(out, FileName(names[j]));
+        out << ",\"cat\":\"job\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << thread
+                << ",\"ts\":" << Micros(origin, start) << ",\"dur\":" << Micros(start, end)
+                << ",\"args\":{\"tokens\":" << s.tokens << ",\"include_pushes\":" << s.pushes
+                << ",\"include_pops\":" << s.pops << ",\"symbol_lookups\":" << s.lookups
+                << ",\"symbol_hits\":" << s.hits << ",\"instructions\":" << s.instructions
+                << ",\"candidate_rows\":" << s.candidates << ",\"branches\":" << s.branches
+                << ",\"branches_grown\":" << s.grown << ",\"relax_visits\":" << s.visits
+                << ",\"bytes\":" << s.bytes << "}}";
+        sep = ",\n";
+
+        for (size_t i = 0; i < s.spans.size(); i ++) {
+            out << sep << "{\"name\":\"" << s.spans[i].name
+                    << "\",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":" << pid
+                    << ",\"tid\":" << s.spans[i].thread
+                    << ",\"ts\":" << Micros(origin, s.spans[i].start)
+                    << ",\"dur\":" << Micros(s.spans[i].start, s.spans[i].end) << "}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//===============================================================================================
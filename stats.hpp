@@ -0,0 +1,120 @@
+//===============================================================================================
+// stats.hpp -- This file contains the class definitions for the counters and timers kept for an
+// assembly with --stats or --trace.
+//
+// A Stats is everything one Job counted and timed.  It only exists when it was asked for: the
+// Parser and the FileStack are handed a pointer to one, which is NULL otherwise, and everything
+// that costs anything -- reading the clock, recording a Span, keeping the lines read from each
+// file -- is behind a test of that pointer, done once per stage or per file rather than per line.
+// The few counters that have to be kept in the hot loops (tokens lexed, symbol lookups and hits,
+// candidate rows, relaxation visits) are plain integers in the objects that do the work, bumped
+// alongside it just as the Relaxer already counts the branches it grows; they are only gathered
+// into the Stats at the end of the parse.
+//
+// A Span is a stage of the Job (the parse, the relaxation, the write, and so on) with the thread
+// it ran on.  Print() writes the counters and the time in each stage for people; Trace() writes
+// the Spans of every Job as Chrome trace-event JSON, with one more event around each Job carrying
+// its counters, so that a slow build can be opened in a trace viewer (chrome://tracing or
+// Perfetto).
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-025   Initial version
+// 2026-10-16  ADCL   U-021   The lines read are kept by file name, since FileIds are the Parser's
+//
+//===============================================================================================
+
+#ifndef __STATS_HPP__
+#define __STATS_HPP__
+
+#ifndef __cplusplus
+#error The file 'stats.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------
+// The Stats class.  The counters are public, in the same way as a Job's, since they are simply
+// filled in by whoever did the counting.
+//-----------------------------------------------------------------------------------------------
+class Stats {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Span {
+        const char *name;
+        Clock::time_point start;
+        Clock::time_point end;
+        unsigned thread;
+    };
+
+public:
+    Stats(void) : pushes(0), pops(0), tokens(0), lookups(0), hits(0), instructions(0),
+            candidates(0), branches(0), grown(0), visits(0), bytes(0) {};
+    virtual ~Stats() {};
+
+public:
+    void Print(std::ostream &out, const std::string &name) const;
+
+    static unsigned Thread(void);
+    static long PeakMemory(void);
+    static void Trace(std::ostream &out, Clock::time_point origin,
+            const std::vector<const Stats *> &jobs, const std::vector<std::string> &names);
+
+public:
+    std::map<std::string, uint64_t> lines;  // the lines read from each file, by name
+    uint64_t pushes;                        // files pushed on the FileStack (and popped off it)
+    uint64_t pops;
+    uint64_t tokens;                        // tokens lexed from the files
+    uint64_t lookups;                       // SymbolTable lookups, and how many found the name
+    uint64_t hits;
+    uint64_t instructions;                  // instructions matched against the OpCodeTable
+    uint64_t candidates;                    // the rows the matches examined
+    uint64_t branches;                      // branches relaxed, those that grew, slots visited
+    uint64_t grown;
+    uint64_t visits;
+    uint64_t bytes;                         // bytes of code emitted
+    std::vector<Span> spans;
+};
+
+//-----------------------------------------------------------------------------------------------
+// A StageTimer records a Span into a Stats from its construction until Stop() (or its
+// destruction), on the thread that constructed it.  With no Stats it does nothing at all.
+//-----------------------------------------------------------------------------------------------
+class StageTimer {
+public:
+    StageTimer(Stats *s, const char *name) : stats(s) {
+        if (!stats) return;
+
+        span.name = name;
+        span.thread = Stats::Thread();
+        span.start = Stats::Clock::now();
+    };
+    virtual ~StageTimer() { Stop(); };
+
+private:
+    StageTimer(const StageTimer &);
+    StageTimer &operator=(const StageTimer &);
+
+public:
+    void Stop(void) {
+        if (!stats) return;
+
+        span.end = Stats::Clock::now();
+        stats->spans.push_back(span);
+        stats = NULL;
+    };
+
+private:
+    Stats *stats;
+    Stats::Span span;
+};
+
+//===============================================================================================
+
+#endif
@@ -1,43 +1,217 @@
+//===============================================================================================
+// symtab.cc -- This file contains the class implementation for the as-cent symbol table.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2015-01-30  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-006   Replaced the std::map with an arena-backed, interned hash table
+// 2026-10-16  ADCL   U-007   Symbols keep a SrcLoc; file names are no longer interned per table
+// 2026-10-16  ADCL   U-009   Removed the global table instances
+// 2026-10-16  ADCL   U-017   Added SYM_EQU
+// 2026-10-16  ADCL   U-018   Added SYM_MACRO
+// 2026-10-16  ADCL   U-020   InitSymbols() moved here from as-cent.cc
+// 2026-10-16  ADCL   U-025   Lookup() counts the lookups and hits
+// 2026-10-16  ADCL   U-025   Lookup() no longer counts; it is const all the way down again
+//
+//===============================================================================================
 
 #include "symtab.h"
+#include "utils.hpp"
 
+#include <algorithm>
 #include <iostream>
 
-#if 0
+const std::string Symbol::SymTypeStrings[] = {"SYM_UNK",
+        "SYM_DIRECTIVE",
+        "SYM_OPCODE",
+        "SYM_REG",
+        "SYM_QUALIFIER",
+        "SYM_LABEL",
+        "SYM_EQU",
+        "SYM_MACRO"};
 
 //-----------------------------------------------------------------------------------------------
-// Create an instance of the symbol tables -- there will be 3:
-// 1) The symbol table for identifiers (right now includes registers and directives)
-// 2) The symbol table for numbers
-// 3) The symbol table for strings
-//
-// With that said, I might even have a symbol table for directives and another for registers.
-// Time will tell if I need this.
+// Names longer than this are folded into a heap buffer rather than on the stack.
 //-----------------------------------------------------------------------------------------------
+static const size_t FOLD_BUFFER = 256;
 
-static SymbolTable _symTab;     // This is a staticly allocated symbol table
-SymbolTable &symTab = _symTab;  // This is a reference to above, but globally available
+//-----------------------------------------------------------------------------------------------
+// SymbolTable::SymbolTable() creates an empty table.  The Arena does not allocate anything until
+// the first symbol is inserted.
+//-----------------------------------------------------------------------------------------------
+SymbolTable::SymbolTable(void) : arena(), names(arena), slots(64, Slot { 0, NULL }), count(0)
+{
+}
 
-static SymbolTable _intTab;     // This is a staticly allocated symbol table
-SymbolTable &intTab = _intTab;  // This is a reference to above, but globally available
+//-----------------------------------------------------------------------------------------------
+// SymbolTable::FoldedFind(std::string_view) and SymbolTable::FoldedIntern(std::string_view) fold
+// the key to lower case and then find (or intern) it in the string pool.
+//-----------------------------------------------------------------------------------------------
+uint32_t SymbolTable::FoldedFind(std::string_view key) const
+{
+    char buf[FOLD_BUFFER];
 
-static SymbolTable _strTab;     // This is a staticly allocated symbol table
-SymbolTable &strTab = _strTab;  // This is a reference to above, but globally available
+    if (key.size() > sizeof(buf)) {
+        std::string big(key.size(), '\0');
+        FoldLower(&big[0], key);
+        return names.Find(big);
+    }
 
-const std::string Symbol::SymTypeStrings[] = {"SYM_UNK",
-        "SYM_DIRECTIVE",
-        "SYM_OPCODE",
-        "SYM_REG",
-        "SYM_QUALIFIER",
-        "SYM_LABEL"};
+    FoldLower(buf, key);
+    return names.Find(std::string_view(buf, key.size()));
+}
+
+uint32_t SymbolTable::FoldedIntern(std::string_view key)
+{
+    char buf[FOLD_BUFFER];
+
+    if (key.size() > sizeof(buf)) {
+        std::string big(key.size(), '\0');
+        FoldLower(&big[0], key);
+        return names.Intern(big);
+    }
+
+    FoldLower(buf, key);
+    return names.Intern(std::string_view(buf, key.size()));
+}
+
+//-----------------------------------------------------------------------------------------------
+// SymbolTable::Lookup(std::string_view) returns the Symbol for key, or NULL.
+//-----------------------------------------------------------------------------------------------
+Symbol *SymbolTable::Lookup(std::string_view key) const
+{
+    uint32_t id = FoldedFind(key);
+    size_t mask = slots.size() - 1;
+
+    if (!id) return NULL;
+
+    for (size_t i = Hash(id) & mask; slots[i].key; i = (i + 1) & mask) {
+        if (slots[i].key == id) return slots[i].sym;
+    }
+
+    return NULL;
+}
+
+//-----------------------------------------------------------------------------------------------
+// SymbolTable::Insert(std::string_view, Symbol::SymType, SrcLoc) adds (or updates) the symbol
+// key and returns it.
+//-----------------------------------------------------------------------------------------------
+Symbol *SymbolTable::Insert(std::string_view key, Symbol::SymType t, SrcLoc loc)
+{
+    uint32_t id = FoldedIntern(key);
+    size_t mask = slots.size() - 1;
+    size_t i;
+
+    for (i = Hash(id) & mask; slots[i].key; i = (i + 1) & mask) {
+        if (slots[i].key == id) {
+            slots[i].sym->SetType(t)->SetLocation(loc);
+            return slots[i].sym;
+        }
+    }
+
+    Symbol *sym = arena.New<Symbol>(id, t, loc);
+    slots[i] = Slot { id, sym };
+
+    if (++ count * 2 > slots.size()) Rehash();
+
+    return sym;
+}
+
+//-----------------------------------------------------------------------------------------------
+// SymbolTable::Rehash() doubles the slot array.
+//-----------------------------------------------------------------------------------------------
+void SymbolTable::Rehash(void)
+{
+    std::vector<Slot> grown(slots.size() * 2, Slot { 0, NULL });
+    size_t mask = grown.size() - 1;
 
+    for (size_t j = 0; j < slots.size(); j ++) {
+        if (!slots[j].key) continue;
 
+        size_t i = Hash(slots[j].key) & mask;
+        while (grown[i].key) i = (i + 1) & mask;
+        grown[i] = slots[j];
+    }
+
+    slots.swap(grown);
+}
+
+//-----------------------------------------------------------------------------------------------
+// SymbolTable::Print() lists the symbols in name order, as the std::map version did.
+//-----------------------------------------------------------------------------------------------
 void SymbolTable::Print(void)
 {
-    for (Iter i = begin(); i != end(); i ++) {
-        Symbol *sym = i->second;
-        std::cout << sym->Key() << " of type " << sym->GetTypeStr() << std::endl;
+    std::vector<const Symbol *> list;
+
+    list.reserve(count);
+    for (size_t i = 0; i < slots.size(); i ++) if (slots[i].key) list.push_back(slots[i].sym);
+
+    std::sort(list.begin(), list.end(), [this](const Symbol *a, const Symbol *b)
+            { return Name(a) < Name(b); });
+
+    for (size_t i = 0; i < list.size(); i ++) {
+        const Symbol *sym = list[i];
+        std::cout << Name(sym) << " of type " << sym->GetTypeStr() << std::endl;
     }
 }
 
-#endif
+//-----------------------------------------------------------------------------------------------
+// InitSymbols(SymbolTable&) is used to initialize a symbol table to the initial state -- with only
+// the supported registers, opcodes, and directives.
+//-----------------------------------------------------------------------------------------------
+void InitSymbols(SymbolTable &symTab)
+{
+    // -- Start by setting up all the possible directives
+    //    -----------------------------------------------
+    symTab.Insert("CPU", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("8086", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("BITS", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("MODEL", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("ORG", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("EVEV", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("EQU", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("INCLUDE", Symbol::SYM_DIRECTIVE);
+    symTab.Insert("ONCE", Symbol::SYM_DIRECTIVE);
+
+    // -- Now, let's establish the register list
+    //    --------------------------------------
+    symTab.Insert("AL", Symbol::SYM_REG);
+    symTab.Insert("AH", Symbol::SYM_REG);
+    symTab.Insert("AX", Symbol::SYM_REG);
+    symTab.Insert("BL", Symbol::SYM_REG);
+    symTab.Insert("BH", Symbol::SYM_REG);
+    symTab.Insert("BX", Symbol::SYM_REG);
+    symTab.Insert("CL", Symbol::SYM_REG);
+    symTab.Insert("CH", Symbol::SYM_REG);
+    symTab.Insert("CX", Symbol::SYM_REG);
+    symTab.Insert("DL", Symbol::SYM_REG);
+    symTab.Insert("DH", Symbol::SYM_REG);
+    symTab.Insert("DX", Symbol::SYM_REG);
+    symTab.Insert("SI", Symbol::SYM_REG);
+    symTab.Insert("DI", Symbol::SYM_REG);
+    symTab.Insert("SP", Symbol::SYM_REG);
+    symTab.Insert("BP", Symbol::SYM_REG);
+    symTab.Insert("CS", Symbol::SYM_REG);
+    symTab.Insert("DS", Symbol::SYM_REG);
+    symTab.Insert("ES", Symbol::SYM_REG);
+    symTab.Insert("SS", Symbol::SYM_REG);
+
+    // -- Next, we setup the qualiiers
+    //    ----------------------------
+    symTab.Insert("BYTE", Symbol::SYM_QUALIFIER);
+    symTab.Insert("BYTE PTR", Symbol::SYM_QUALIFIER);
+    symTab.Insert("WORD", Symbol::SYM_QUALIFIER);
+    symTab.Insert("WORD PTR", Symbol::SYM_QUALIFIER);
+    symTab.Insert("DWORD", Symbol::SYM_QUALIFIER);
+    symTab.Insert("DWORD PTR", Symbol::SYM_QUALIFIER);
+    symTab.Insert("CS:", Symbol::SYM_QUALIFIER);
+    symTab.Insert("DS:", Symbol::SYM_QUALIFIER);
+    symTab.Insert("ES:", Symbol::SYM_QUALIFIER);
+    symTab.Insert("SS:", Symbol::SYM_QUALIFIER);
+
+    // -- Finally, the opcodes -- these are not in the symbol table; they are found through the
+    //    perfect hash built by OpCodeInit()
+    //    -------------------------------------------------------------------------------------
+}
+
+//===============================================================================================
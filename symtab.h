@@ -4,97 +4,147 @@
 //
 // The first thing to note is that all symbols are global to the file.  This means that there is
 // no need to manage any scope.  When we begin reading the top-level file we create a symbol
-// table and that table lives with all its symbols until we finish with the file.
+// table and that table lives with all its symbols until we finish with the file.  The table is
+// owned by the Parser for that file, so several files can be assembled at once.
+//
+// Since everything in the table lives exactly as long as the table, the Symbol records and the
+// text of their names are carved out of an Arena owned by the table and are all released at once
+// with it.  Names are interned (and folded to lower case, since symbols are not case sensitive),
+// and the table itself is an open-addressing hash keyed on the interned name id.
 //
 // I expect these class definitions to change as I see new requirements.
 //
 //    Date     PGMR  Tracker  Description
 // ----------  ----  -------  -------------------------------------------------------------------
 // 2015-01-30  ADCL  Initial  This is the first version
+// 2026-10-16  ADCL   U-006   Replaced the std::map with an arena-backed, interned hash table
+// 2026-10-16  ADCL   U-007   A Symbol keeps a SrcLoc rather than a file name
+// 2026-10-16  ADCL   U-009   Removed the global tables; each Parser owns its own SymbolTable
+// 2026-10-16  ADCL   U-012   A Symbol has a value (for a label, its offset in the section)
+// 2026-10-16  ADCL   U-016   An undefined Symbol keeps the list of Fixups waiting for it
+// 2026-10-16  ADCL   U-017   Added SYM_EQU; an EQU may be an expression kept in the ExprPool
+// 2026-10-16  ADCL   U-018   Added SYM_MACRO
+// 2026-10-16  ADCL   U-020   Declared InitSymbols()
+// 2026-10-16  ADCL   U-025   Count the lookups, and how many find the name, for --stats
+// 2026-10-16  ADCL   U-025   The lookups are counted by the Parser; Lookup() writes nothing
 //
 //===============================================================================================
 
-#if 0
-//#ifndef __SYMTAB_H__
+#ifndef __SYMTAB_H__
 #define __SYMTAB_H__
 
-#include "in-file.h"
+#ifndef __cplusplus
+#error The file 'symtab.h' is not being compiled by a C++ compiler.
+#endif
+
+#include "arena.hpp"
+#include "intern.hpp"
+#include "srcfile.hpp"
 
-#include <map>
+#include <cstdint>
 #include <string>
-#include <algorithm>
+#include <string_view>
+#include <vector>
 
 //-----------------------------------------------------------------------------------------------
 // The Symbol class will contain all the attributes of a symbol used by the assembler.  I expect
 // that this class definition will evolve over time as I find needs to track all the attributes
 // required.
 //
-// Note: there are 2 ways to create an instance of Symbol:
-// Symbol::Factory(...) -- this will create a new instance of Symbol using the new operator and
-// return a pointer to this new Symbol instance.
-// new Symbol(...) -- this is a more common way to create a new symbol instance.
-//
-// The reason to use `Symbol::Factory` over `new Symbol` is this: function chaining.
-// Symbol::Factory allows for a cleaner representation of the following:
+// Symbols are only ever created by SymbolTable::Insert(), which allocates them from the table's
+// Arena.  Insert() returns the Symbol so that calls can still be chained:
 //
-//     symTab->Insert(Symbol::Factory("reg")->SetType(SYM_REG));
+//     symTab.Insert("reg")->SetType(Symbol::SYM_REG);
 //
-// As I write this first iteration, there is not much need for this kind of construct as the
-// Type can be set simply in the constructor -- but I'm planning ahead.
+// A Symbol must stay trivially destructible -- its destructor is never called.
 //-----------------------------------------------------------------------------------------------
 class Symbol {
 public:
     typedef enum {SYM_UNK, SYM_DIRECTIVE, SYM_OPCODE, SYM_REG, SYM_QUALIFIER,
-            SYM_LABEL} SymType;
+            SYM_LABEL, SYM_EQU, SYM_MACRO} SymType;
     static const std::string SymTypeStrings[];
 
 protected:
-    std::string symName;           // This is a duplicate of the key value
+    uint32_t symName;              // This is the interned id of the key value
     SymType type;
-    std::string fileName;
-    long lineNum;
+    bool defined;                  // This is true once the value is known
+    uint32_t pending;              // The last Fixup waiting for the value (index + 1), or 0
+    uint32_t expr;                 // For an EQU that is not a constant, its ExprNode; else 0
+    SrcLoc loc;                    // This is where the symbol was defined
+    int64_t value;
 
 public:
-    Symbol(const std::string &n, SymType t = SYM_UNK) : symName(n), type(t),
-            fileName(InputFile::FileName()), lineNum(InputFile::LineNum())
-            { std::transform(symName.begin(), symName.end(), symName.begin(), ::tolower); };
-    static Symbol *Factory(const std::string &n, SymType t = SYM_UNK)
-            { return new Symbol(n, t); };
-    virtual ~Symbol() {};
+    Symbol(uint32_t n, SymType t, SrcLoc l) : symName(n), type(t), defined(false), pending(0),
+            expr(0), loc(l), value(0) {};
 
 public:
     Symbol *SetType(SymType t) { type = t; return this; };
     SymType GetType(void) const { return type; };
     const std::string &GetTypeStr(void) const { return SymTypeStrings[type]; };
-    std::string Key(void) const { return symName; };
+    uint32_t Key(void) const { return symName; };
+    FileId FileNum(void) const { return loc.file; };
+    long LineNum(void) const { return loc.line; };
+    SrcLoc Location(void) const { return loc; };
+    void SetLocation(SrcLoc l) { loc = l; };
+    bool IsDefined(void) const { return defined; };
+    int64_t Value(void) const { return value; };
+    void SetValue(int64_t v) { value = v; defined = true; };
+    uint32_t Expr(void) const { return expr; };
+    void SetExpr(uint32_t e) { expr = e; defined = true; };
+    uint32_t Pending(void) const { return pending; };
+    void SetPending(uint32_t f) { pending = f; };
 };
 
-//-----------------------------------------------------------------------------------------------
-// These 2 typedefs are here to make coding easier (and the resulting code easier to read!)
-//-----------------------------------------------------------------------------------------------
-typedef std::map<std::string, Symbol *> Map;  // The map pair is referred to as a Map
-typedef Map::iterator Iter;                   // Needed for lookups
-
 //-----------------------------------------------------------------------------------------------
 // The SymbolTable class will be the whole symbol table -- in all its glory!  Disappointed?  I
 // think it's kinda anti-climactic.
+//
+// Lookup() and Insert() fold the name to lower case.  Inserting a name that is already in the
+// table updates the existing Symbol, just as assigning to the old std::map did.
 //-----------------------------------------------------------------------------------------------
-class SymbolTable : protected Map {
+class SymbolTable {
 public:
-    Symbol *Lookup(std::string key)
-            { std::transform(key.begin(), key.end(), key.begin(), ::tolower);
-                Iter tmp = find(key); return (tmp == end()?NULL:tmp->second); };
-    Symbol *Insert(Symbol *sym) { (*this)[sym->Key()] = sym; return sym; };
+    SymbolTable(void);
+    virtual ~SymbolTable() {};
+
+private:
+    SymbolTable(const SymbolTable &);
+    SymbolTable &operator=(const SymbolTable &);
+
+public:
+    Symbol *Lookup(std::string_view key) const;
+    Symbol *Insert(std::string_view key, Symbol::SymType t = Symbol::SYM_UNK,
+            SrcLoc loc = SrcLoc { 0, 0 });
+
+    std::string_view Name(const Symbol *sym) const { return names.Str(sym->Key()); };
+    std::string_view Name(uint32_t id) const { return names.Str(id); };
+    size_t Count(void) const { return count; };
 
     void Print(void);
+
+private:
+    struct Slot {
+        uint32_t key;                       // the interned name id; 0 means the slot is empty
+        Symbol *sym;
+    };
+
+private:
+    static size_t Hash(uint32_t key) { return (size_t)key * 0x9e3779b1u; };
+    uint32_t FoldedFind(std::string_view key) const;
+    uint32_t FoldedIntern(std::string_view key);
+    void Rehash(void);
+
+private:
+    Arena arena;
+    StringPool names;
+    std::vector<Slot> slots;
+    size_t count;
 };
 
 //-----------------------------------------------------------------------------------------------
-// Some global declarations so that other source files can access the symbol tables instances --
-// collectively refferred to as the "Symbol Table".
+// InitSymbols() fills a new SymbolTable with the reserved words: the directives, the registers
+// and the qualifiers.
 //-----------------------------------------------------------------------------------------------
-extern SymbolTable &symTab;
-extern SymbolTable &intTab;
-extern SymbolTable &strTab;
+void InitSymbols(SymbolTable &symTab);
 
 #endif
@@ -0,0 +1,299 @@
+//===============================================================================================
+// test-asm.cc -- This file contains the assembler's regression tests.
+//
+// Each Case is a small source, assembled as a flat binary, and either the bytes it must produce
+// or the error it must report.  The sources are written to a temporary directory and run through
+// the Parser exactly as as-cent runs them, so a Case covers the lexer, the operand matching, the
+// encoder and the Relaxer together.  Every Case is run; the failures are listed on stderr, and
+// the exit status is the number that failed.
+//
+// What depends on the command line (the cache, the directory a run is started in) can only be
+// tested by running as-cent itself.  Given the path of an as-cent, test-asm runs those tests too.
+//
+// It is not part of the assembler.  Build it against the assembler's own sources:
+//
+//     gcc -O2 -c OpCodeTable.c
+//     g++ -O2 -std=c++17 -pthread -o test-asm test-asm.cc OpCodeTable.o
+//             $(ls *.cc *.cpp | grep -v -e '^as-cent.cc$' -e '^bench-' -e '^test-')
+//     ./test-asm [path/to/as-cent]
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2026-10-16  ADCL   U-017   Initial version, with forward EQUs as byte immediates
+// 2026-10-16  ADCL   U-017   Added the range of a word Fixup
+// 2026-10-16  ADCL   U-019   Added the command-line tests, with a cache shared by 2 directories
+// 2026-10-16  ADCL   U-008   Added INCLUDE with an empty file name
+// 2026-10-16  ADCL   U-003   Added numbers too large for 64 bits
+// 2026-10-16  ADCL   U-009   Added -j with counts that are not positive numbers
+//
+//===============================================================================================
+
+#include "OpCodeTable.h"
+#include "parser.hpp"
+#include "symtab.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+//-----------------------------------------------------------------------------------------------
+// A Case is one test.  With no error, bytes are the code expected, in hex; otherwise error is a
+// part of the diagnostic expected, and bytes are not checked.
+//-----------------------------------------------------------------------------------------------
+struct Case {
+    const char *name;
+    const char *source;
+    const char *bytes;
+    const char *error;
+};
+
+static const Case cases[] = {
+    // -- a forward EQU is released like a label, into a field as wide as the row gives it
+    {"forward EQU in INT", "\tint VEC\nVEC EQU 21h\n", "cd21", NULL},
+    {"forward EQU in MOV r8,imm", "\tmov al, K\nK EQU 5\n", "b005", NULL},
+    {"forward EQU in MOV byte [m],imm", "\tmov byte [bx], K\nK EQU 5\n", "c60705", NULL},
+    {"forward label EQU in MOV r8,imm", "\tmov al, B2\nB2: EQU 7\n", "b007", NULL},
+    {"forward EQU in ADD r16,imm", "\tadd ax, K\nK EQU 5\n", "050500", NULL},
+    {"forward EQU in MOV r16,imm", "\tmov cx, K\nK EQU 1234h\n", "b93412", NULL},
+    {"forward EQU too large for a byte", "\tmov al, K\nK EQU 300\n", NULL, "value out of range"},
+    {"forward EQU too small for a byte", "\tint K\nK EQU -129\n", NULL, "value out of range"},
+
+    // -- a word is checked just as a byte is
+    {"forward EQU at the top of a word", "\tmov ax, K\nK EQU 0FFFFh\n", "b8ffff", NULL},
+    {"forward EQU too large for a word", "\tmov ax, K\nK EQU 65536\n", NULL, "value out of range"},
+    {"forward EQU too small for a word", "\tpush K\nK EQU -32769\n", NULL, "value out of range"},
+    {"address past the top of a word", "\torg 0FFFEh\n\tmov ax, L\nL:\n", NULL,
+            "value out of range"},
+
+    // -- an empty name would have the FileStack read stdin
+    {"INCLUDE with an empty name", "\tinclude \"\"\n", NULL, "missing a file name"},
+    {"INCLUDE with a blank name", "\tinclude \"  \"\n", NULL, "missing a file name"},
+
+    // -- a number must fit in 64 bits rather than wrap
+    {"largest hex number", "\tmov ax, 0FFFFFFFFFFFFFFFFh\n", "b8ffff", NULL},
+    {"hex number past 64 bits", "\tmov ax, 10000000000000005h\n", NULL, "invalid number"},
+    {"decimal number past 64 bits", "\tmov ax, 18446744073709551621\n", NULL, "invalid number"},
+};
+
+//-----------------------------------------------------------------------------------------------
+// Hex() is bytes in hex, as the Cases give them.
+//-----------------------------------------------------------------------------------------------
+static std::string Hex(const uint8_t *p, size_t n)
+{
+    std::string s;
+    char buf[3];
+
+    for (size_t i = 0; i < n; i ++) {
+        snprintf(buf, sizeof(buf), "%02x", p[i]);
+        s += buf;
+    }
+
+    return s;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Run() assembles one Case from a file in dir, and returns why it failed, or "" if it passed.
+//-----------------------------------------------------------------------------------------------
+static std::string Run(const Case &c, const std::string &dir)
+{
+    std::string file = dir + "/case.asm";
+    std::ostringstream diag;
+    std::string got;
+
+    std::ofstream(file.c_str()) << c.source;
+
+    try {
+        Parser parser(file, diag);
+
+        InitSymbols(parser.Symbols());
+        parser.AllowExternals(false);
+        parser.Parse();
+
+        if (!parser.Errors()) got = Hex(parser.Code().Data(), parser.Code().Size());
+    } catch (std::exception &e) {
+        diag << e.what() << '\n';
+    }
+
+    unlink(file.c_str());
+
+    if (c.error) {
+        if (diag.str().find(c.error) == std::string::npos) {
+            return "expected the error '" + std::string(c.error) + "', got '" + diag.str() + "'";
+        }
+    } else if (diag.str() != "") {
+        return "expected " + std::string(c.bytes) + ", got '" + diag.str() + "'";
+    } else if (got != c.bytes) {
+        return "expected " + std::string(c.bytes) + ", got " + got;
+    }
+
+    return "";
+}
+
+//-----------------------------------------------------------------------------------------------
+// Write() writes text to path.
+//-----------------------------------------------------------------------------------------------
+static void Write(const std::string &path, const std::string &text)
+{
+    std::ofstream(path.c_str()) << text;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Output() is the contents of path, in hex.
+//-----------------------------------------------------------------------------------------------
+static std::string Output(const std::string &path)
+{
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    return Hex(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+}
+
+//-----------------------------------------------------------------------------------------------
+// CacheFromTwoDirectories() assembles one source with `-I inc` and one cache, from 2 directories
+// with different inc/defs.inc files.  Each run must see its own include, not the other's output.
+//-----------------------------------------------------------------------------------------------
+static std::string CacheFromTwoDirectories(const std::string &ascent, const std::string &dir)
+{
+    std::string why;
+
+    Write(dir + "/use.asm", "\tinclude \"defs.inc\"\n\tmov al, K\n");
+
+    for (int i = 1; i <= 2 && why == ""; i ++) {
+        std::string p = dir + "/p" + std::to_string(i);
+        std::string expected = "b00" + std::to_string(i);
+
+        mkdir(p.c_str(), 0777);
+        mkdir((p + "/inc").c_str(), 0777);
+        Write(p + "/inc/defs.inc", "K EQU " + std::to_string(i) + "\n");
+
+        std::string cmd = "cd '" + p + "' && '" + ascent + "' -f bin -I inc -c '" + dir
+                + "/cache' -o . '" + dir + "/use.asm' 2>/dev/null";
+
+        if (system(cmd.c_str()) != 0) why = "as-cent failed in p" + std::to_string(i);
+        else if (Output(p + "/use.bin") != expected) {
+            why = "expected " + expected + " in p" + std::to_string(i) + ", got "
+                    + Output(p + "/use.bin");
+        }
+    }
+
+    std::string rm = "rm -rf '" + dir + "/p1' '" + dir + "/p2' '" + dir + "/cache' '" + dir
+            + "/use.asm'";
+    if (system(rm.c_str()) != 0) why = "unable to clean up " + dir;
+
+    return why;
+}
+
+//-----------------------------------------------------------------------------------------------
+// ThreadCounts() gives -j counts that are not positive numbers, each of which must be a usage
+// error (exit status 2), and then one that is.
+//-----------------------------------------------------------------------------------------------
+static std::string ThreadCounts(const std::string &ascent, const std::string &dir)
+{
+    static const char *const bad[] = {"0", "-1", " 2", "2x", "abc", "99999999999", ""};
+    std::string src = dir + "/threads.asm";
+    std::string why;
+
+    Write(src, "\tnop\n");
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]) && why == ""; i ++) {
+        std::string cmd = "'" + ascent + "' -j '" + bad[i] + "' -f bin -o '" + dir + "' '" + src
+                + "' 2>/dev/null; test $? -eq 2";
+
+        if (system(cmd.c_str()) != 0) {
+            why = std::string("-j '") + bad[i] + "' was not a usage error";
+        }
+    }
+
+    if (why == "") {
+        std::string cmd = "'" + ascent + "' -j 3 -f bin -o '" + dir + "' '" + src + "'";
+
+        if (system(cmd.c_str()) != 0) why = "as-cent failed with -j 3";
+        else if (Output(dir + "/threads.bin") != "90") why = "-j 3 did not assemble the file";
+    }
+
+    std::string rm = "rm -f '" + src + "' '" + dir + "/threads.bin'";
+    if (system(rm.c_str()) != 0) why = "unable to clean up " + dir;
+
+    return why;
+}
+
+//-----------------------------------------------------------------------------------------------
+// The command-line tests, each run with the path of as-cent and a directory of its own to use.
+//-----------------------------------------------------------------------------------------------
+struct Command {
+    const char *name;
+    std::string (*run)(const std::string &ascent, const std::string &dir);
+};
+
+static const Command commands[] = {
+    {"cache shared by 2 directories with -I", CacheFromTwoDirectories},
+    {"-j with a count that is not a positive number", ThreadCounts},
+};
+
+//-----------------------------------------------------------------------------------------------
+// main() is the test entry point.
+//-----------------------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    char dir[] = "/tmp/test-asm.XXXXXX";
+    size_t count = sizeof(cases) / sizeof(cases[0]);
+    int failed = 0;
+
+    if (argc > 2) {
+        std::cerr << "usage: test-asm [path/to/as-cent]" << std::endl;
+        return 1;
+    }
+
+    if (!OpCodeInit()) {
+        std::cerr << "test-asm: the OpCodeTable is not grouped by mnemonic" << std::endl;
+        return 1;
+    }
+
+    if (!mkdtemp(dir)) {
+        std::cerr << "test-asm: unable to create a directory for the sources" << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < count; i ++) {
+        std::string why = Run(cases[i], dir);
+
+        if (why != "") {
+            std::cerr << "test-asm: " << cases[i].name << ": " << why << std::endl;
+            failed ++;
+        }
+    }
+
+    if (argc == 2) {
+        char ascent[PATH_MAX];
+
+        if (!realpath(argv[1], ascent)) {
+            std::cerr << "test-asm: " << argv[1] << " not found" << std::endl;
+            rmdir(dir);
+            return 1;
+        }
+
+        for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i ++, count ++) {
+            std::string why = commands[i].run(ascent, dir);
+
+            if (why != "") {
+                std::cerr << "test-asm: " << commands[i].name << ": " << why << std::endl;
+                failed ++;
+            }
+        }
+    }
+
+    rmdir(dir);
+
+    std::cerr << "test-asm: " << count - failed << " of " << count << " passed" << std::endl;
+    return failed;
+}
+
+//===============================================================================================
@@ -1,7 +1,79 @@
+//===============================================================================================
+// utils.hpp -- This file contains small worker functions primarily used in the parser, but
+// could be useful somewhere else.
+//
+// There are 2 flavors of the trim functions.  The std::string versions return a new string
+// (and therefore allocate).  The std::string_view versions return a narrower view of the same
+// characters and never allocate; these are the ones to use on the hot path.
+//
+//    Date     PGMR  Tracker  Description
+// ----------  ----  -------  -------------------------------------------------------------------
+// 2015-02-09  ADCL   #263    Moved ltrim(), rtrim(), and trim() into their own file
+// 2026-10-16  ADCL   U-002   Added allocation-free string_view versions and a character class
+//                            table; ltrim() no longer throws on an all-whitespace string
+// 2026-10-16  ADCL   U-006   Added FoldLower() and HashBytes() for the interned symbol table
+// 2026-10-16  ADCL   U-023   Added TakeLine(), shared by InputFile and Lexer::LexLines()
+//
+//===============================================================================================
 
+#ifndef __UTILS_HPP__
+#define __UTILS_HPP__
+
+#ifndef __cplusplus
+#error The file 'utils.hpp' is not being compiled by a C++ compiler.
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//-----------------------------------------------------------------------------------------------
+// These are the character classes.  A character may belong to several classes, so they are bit
+// flags.  CC_SPACE is exactly the set " \f\n\r\t\v" that the trim functions have always used.
 //-----------------------------------------------------------------------------------------------
-// Finally, some worker function primarily used in the parser, but could be useful somewhere
-// else.
+enum {
+    CC_SPACE    = 0x01,
+    CC_DIGIT    = 0x02,
+    CC_ALPHA    = 0x04,
+    CC_HEX      = 0x08,
+    CC_IDENT    = 0x10,         // may appear in an identifier after the first character
+};
+
+//-----------------------------------------------------------------------------------------------
+// CharClassTable is built at compile time so that classifying a character is a single indexed
+// load rather than a scan of a delimiter string.
+//-----------------------------------------------------------------------------------------------
+struct CharClassTable {
+    unsigned char cls[256];
+
+    constexpr CharClassTable(void) : cls() {
+        const char *ws = " \f\n\r\t\v";
+        for (int i = 0; ws[i]; i ++) cls[(unsigned char)ws[i]] |= CC_SPACE;
+        for (int c = '0'; c <= '9'; c ++) cls[c] |= CC_DIGIT | CC_HEX | CC_IDENT;
+        for (int c = 'A'; c <= 'Z'; c ++) cls[c] |= CC_ALPHA | CC_IDENT;
+        for (int c = 'a'; c <= 'z'; c ++) cls[c] |= CC_ALPHA | CC_IDENT;
+        for (int c = 'A'; c <= 'F'; c ++) cls[c] |= CC_HEX;
+        for (int c = 'a'; c <= 'f'; c ++) cls[c] |= CC_HEX;
+        cls['_'] |= CC_ALPHA | CC_IDENT;
+        cls['.'] |= CC_ALPHA | CC_IDENT;
+        cls['?'] |= CC_ALPHA | CC_IDENT;
+        cls['@'] |= CC_ALPHA | CC_IDENT;
+        cls['$'] |= CC_IDENT;
+    };
+};
+
+inline constexpr CharClassTable charClass;
+
+inline bool IsClass(char c, unsigned cls) { return (charClass.cls[(unsigned char)c] & cls) != 0; }
+inline bool IsSpace(char c) { return IsClass(c, CC_SPACE); }
+
+//-----------------------------------------------------------------------------------------------
+// The original std::string versions.  Each returns a new string.
 //-----------------------------------------------------------------------------------------------
 
 inline std::string rtrim(const std::string& s, const std::string& delimiters = " \f\n\r\t\v")
@@ -13,7 +85,8 @@ inline std::string rtrim(const std::string& s, const std::string& delimiters = "
 
 inline std::string ltrim(const std::string& s, const std::string& delimiters = " \f\n\r\t\v")
 {
-    return s.substr(s.find_first_not_of(delimiters));
+    std::string::size_type pos = s.find_first_not_of(delimiters);
+    return (pos == std::string::npos ? std::string() : s.substr(pos));
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -22,3 +95,133 @@ inline std::string trim(const std::string& s, const std::string& delimiters = "
 {
     return ltrim(rtrim(s, delimiters), delimiters);
 }
+
+//-----------------------------------------------------------------------------------------------
+// The std::string_view versions.  With no delimiters, whitespace is found through the character
+// class table.  An all-whitespace (or empty) view trims to an empty view.
+//-----------------------------------------------------------------------------------------------
+
+inline std::string_view rtrim(std::string_view s)
+{
+    size_t len = s.size();
+    while (len && IsSpace(s[len - 1])) len --;
+    return s.substr(0, len);
+}
+
+//-----------------------------------------------------------------------------------------------
+
+inline std::string_view ltrim(std::string_view s)
+{
+    size_t pos = 0;
+    while (pos < s.size() && IsSpace(s[pos])) pos ++;
+    return s.substr(pos);
+}
+
+//-----------------------------------------------------------------------------------------------
+
+inline std::string_view trim(std::string_view s)
+{
+    return ltrim(rtrim(s));
+}
+
+//-----------------------------------------------------------------------------------------------
+
+inline std::string_view rtrim(std::string_view s, std::string_view delimiters)
+{
+    return s.substr(0, s.find_last_not_of(delimiters) + 1);
+}
+
+//-----------------------------------------------------------------------------------------------
+
+inline std::string_view ltrim(std::string_view s, std::string_view delimiters)
+{
+    size_t pos = s.find_first_not_of(delimiters);
+    return (pos == std::string_view::npos ? std::string_view() : s.substr(pos));
+}
+
+//-----------------------------------------------------------------------------------------------
+
+inline std::string_view trim(std::string_view s, std::string_view delimiters)
+{
+    return ltrim(rtrim(s, delimiters), delimiters);
+}
+
+//-----------------------------------------------------------------------------------------------
+// FoldLower() copies src to dst (which must have room for src.size() characters) converting
+// 'A'..'Z' to lower case.  With SSE2 this is done 16 characters at a time, the same way that
+// MakeMnemonicN() folds mnemonics.
+//-----------------------------------------------------------------------------------------------
+inline void FoldLower(char *dst, std::string_view src)
+{
+    size_t i = 0;
+
+#ifdef __SSE2__
+    for ( ; i + 16 <= src.size(); i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src.data() + i));
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_add_epi8(v, _mm_and_si128(upper,
+                _mm_set1_epi8(0x20))));
+    }
+#endif
+
+    for ( ; i < src.size(); i ++) {
+        char c = src[i];
+        dst[i] = (c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------
+// HashBytes() is a fast 64-bit hash of a block of memory; it consumes 8 bytes per step.  It is
+// meant for hash tables, not for anything that needs to resist an attacker.
+//-----------------------------------------------------------------------------------------------
+inline uint64_t HashMix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t HashBytes(const void *data, size_t len, uint64_t seed = 0)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    uint64_t h = seed ^ (len * 0x9e3779b97f4a7c15ull);
+    uint64_t w;
+
+    for ( ; len >= 8; p += 8, len -= 8) {
+        memcpy(&w, p, 8);
+        h = (h ^ HashMix(w)) * 0x9e3779b97f4a7c15ull;
+    }
+
+    if (len) {
+        w = 0;
+        memcpy(&w, p, len);
+        h = (h ^ HashMix(w)) * 0x9e3779b97f4a7c15ull;
+    }
+
+    return HashMix(h);
+}
+
+//-----------------------------------------------------------------------------------------------
+// TakeLine() returns the source line that starts at p and moves p past its terminator.  The
+// newline, any carriage return, and any trailing DOS EOF (0x1a) are not part of the line.  This
+// is the one definition of a line, so that a file lexed ahead splits exactly as it reads.
+//-----------------------------------------------------------------------------------------------
+inline std::string_view TakeLine(const char *&p, const char *end)
+{
+    const char *start = p;
+    const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+    size_t len = (eol ? eol : end) - start;
+
+    p = (eol ? eol + 1 : end);
+    while (len && (start[len - 1] == '\r' || start[len - 1] == '\x1a')) len --;
+
+    return std::string_view(start, len);
+}
+
+//===============================================================================================
+
+#endif